@@ -0,0 +1,47 @@
+// src/native/diarization/include/allocation-counter.h
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Process-wide heap allocation counter, fed by the replacement operator new
+ * Allocations made while a RuntimeScope is open (an ONNX Runtime inference in flight, on any
+ * thread) are counted apart, so the pipeline's own allocations can be told from the runtime's.
+ * Counting is off until enable() (--profile): the replacement allocation functions then only
+ * test a relaxed flag and forward to malloc. When on, counting is a relaxed atomic increment
+ * per allocation. By default only operator new is counted; a DIARIZATION_ALLOCATION_TRACKING build also interposes malloc and its relatives
+ * (glibc), so allocations made by C code and third-party libraries show up as well.
+ */
+namespace AllocationCounter {
+    struct Snapshot {
+        uint64_t allocations = 0;          // Outside inference
+        uint64_t bytes = 0;
+        uint64_t runtime_allocations = 0;  // Inside ONNX Runtime inference
+    };
+    
+    Snapshot snapshot();
+    
+    /**
+     * Start counting; counters stay at zero until then
+     */
+    void enable();
+    
+    /**
+     * Whether malloc is interposed (DIARIZATION_ALLOCATION_TRACKING build on glibc)
+     */
+    bool tracking_build();
+    
+    /**
+     * Marks an ONNX Runtime call; allocations during its lifetime count as the runtime's
+     */
+    class RuntimeScope {
+    private:
+        bool counted_;  // Counting was on when the scope opened
+    
+    public:
+        RuntimeScope();
+        ~RuntimeScope();
+        RuntimeScope(const RuntimeScope&) = delete;
+        RuntimeScope& operator=(const RuntimeScope&) = delete;
+    };
+}
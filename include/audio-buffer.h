@@ -0,0 +1,70 @@
+// src/native/diarization/include/audio-buffer.h
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * AudioBuffer holds a recording as 16-bit PCM, half the memory of float samples
+ * Samples are either owned or a read-only mapping of a raw PCM file, in which case the
+ * page cache backs them and nothing is copied at load. Conversion to float happens only
+ * when a model input window or an embedding crop is filled, with the SIMD kernels, and can
+ * apply a gain and pre-emphasis in the same pass. Copies and slices share the samples.
+ */
+class AudioBuffer {
+private:
+    struct Storage;
+    
+    std::shared_ptr<const Storage> storage_;
+    const int16_t* samples_;
+    size_t size_;
+    
+    AudioBuffer(std::shared_ptr<const Storage> storage, const int16_t* samples, size_t size);
+
+public:
+    static constexpr float kScale = 1.0f / 32768.0f;  // int16 -> [-1, 1)
+    
+    AudioBuffer();
+    
+    /**
+     * Take ownership of 16-bit samples
+     */
+    static AudioBuffer from_pcm16(std::vector<int16_t> samples);
+    
+    /**
+     * Quantize float samples in [-1, 1] to 16 bits (rounded, clipped)
+     */
+    static AudioBuffer from_float(const float* samples, size_t count);
+    
+    /**
+     * Map a headerless 16-bit native-endian PCM file (read into memory where mmap is unavailable)
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    static AudioBuffer map_pcm16(const std::string& path);
+    
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const int16_t* data() const { return samples_; }
+    
+    /**
+     * Whether the samples are a mapping of the source file
+     */
+    bool mapped() const;
+    
+    float operator[](size_t i) const { return samples_[i] * kScale; }
+    
+    /**
+     * Convert samples [begin, begin + count) to float, clipped to the end of the buffer
+     * out[i] = gain * x[i] - emphasis * gain * x[i - 1], with x[-1] taken as 0
+     * @return Number of samples written
+     */
+    size_t read(size_t begin, size_t count, float* out, float gain = 1.0f, float emphasis = 0.0f) const;
+    
+    /**
+     * Samples [begin, end) as a buffer sharing this one's storage
+     */
+    AudioBuffer slice(size_t begin, size_t end) const;
+};
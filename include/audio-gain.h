@@ -0,0 +1,42 @@
+// src/native/diarization/include/audio-gain.h
+#pragma once
+
+#include "audio-buffer.h"
+#include <vector>
+#include <cstddef>
+
+/**
+ * AudioGain holds the peak level of every block of a recording, computed in one vectorized
+ * pass at the start of each segmentation run (track_speakers), before the first window
+ * The peak of any range is the maximum over the blocks it covers plus a scan of at most two
+ * partial blocks, so overlapping model windows get their normalization gain without
+ * rescanning their samples. The gain is exact: the same 1 / peak a per-window scan would give.
+ */
+class AudioGain {
+private:
+    static constexpr size_t kBlockSize = 256;
+    
+    AudioBuffer audio_;
+    std::vector<int32_t> block_peaks_;  // Largest |sample| per block, in PCM units
+
+public:
+    /**
+     * Measure block peaks of audio (the samples are shared, not copied)
+     */
+    void analyze(const AudioBuffer& audio);
+    
+    /**
+     * Largest |sample| in [begin, end), clipped to the analyzed audio
+     */
+    float peak(size_t begin, size_t end) const;
+    
+    /**
+     * Factor that brings [begin, end) to a peak of 1; 1 for silence (peak below 1e-6)
+     */
+    float gain(size_t begin, size_t end) const;
+    
+    /**
+     * Peak of the whole recording
+     */
+    float peak() const { return peak(0, audio_.size()); }
+};
@@ -0,0 +1,72 @@
+// src/native/diarization/include/autotune.h
+#pragma once
+
+#include "diarize-cli.h"
+#include <string>
+#include <vector>
+
+/**
+ * Best runtime settings found for one host and model pair
+ */
+struct TuneResult {
+    int intra_op_threads = 0;         // ONNX Runtime intra-op threads per model
+    int segmentation_batch_size = 0;  // Windows per segmentation model run
+    int embedding_batch_size = 0;     // Segments per embedding model run
+    double segmentation_ms = 0.0;     // Measured time per window at these settings
+    double embedding_ms = 0.0;        // Measured time per embedded segment at these settings
+};
+
+/**
+ * Autotuner benchmarks the loaded models on this CPU over a grid of thread counts and batch
+ * sizes, and caches the fastest combination per host
+ * Both models share one thread count (they run one after the other), chosen to minimize the
+ * sum of the per-window and per-segment times; each model then gets its fastest batch size at
+ * that thread count. The cache is keyed by host name, CPU count, model files and embedding
+ * input length, so a copied home directory or a model update does not apply stale settings.
+ */
+class Autotuner {
+private:
+    const DiarizeOptions& options_;
+    bool verbose_;
+
+public:
+    Autotuner(const DiarizeOptions& options, bool verbose = false);
+    
+    /**
+     * Run the benchmark grid
+     * @param result Best settings found
+     * @return false if no model could be benchmarked
+     */
+    bool run(TuneResult& result);
+    
+    /**
+     * Per-host cache file: $XDG_CACHE_HOME (or ~/.cache, %LOCALAPPDATA%)/whisperdesk-diarization/autotune-<host>.conf
+     */
+    static std::string default_cache_path();
+    
+    /**
+     * Write settings to a cache file, keyed by this host and the options' model files
+     */
+    static bool save(const std::string& path, const DiarizeOptions& options, const TuneResult& result);
+    
+    /**
+     * Read settings from a cache file
+     * @return false if the file is missing or was tuned on another host or for other models
+     */
+    static bool load(const std::string& path, const DiarizeOptions& options, TuneResult& result);
+
+private:
+    static std::string host_name();
+    static std::string model_key(const std::string& path);
+    static std::vector<int> thread_grid();
+    
+    /**
+     * Milliseconds per window at each batch size (negative where the model refused the batch)
+     */
+    std::vector<double> time_segmentation(int threads, const std::vector<int>& batches);
+    
+    /**
+     * Milliseconds per segment at each batch size (negative where the model refused the batch)
+     */
+    std::vector<double> time_embedding(int threads, const std::vector<int>& batches);
+};
@@ -0,0 +1,78 @@
+// src/native/diarization/include/binary-io.h
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * Helpers for the engine's binary files (state, checkpoints, shard results)
+ * Fields are stored in host byte order: these files are exchanged between processes of the
+ * same build, not between platforms.
+ */
+namespace BinaryIO {
+
+template <typename T>
+inline void write_value(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+inline bool read_value(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/**
+ * Bytes between the read position and the end of the file, 0 if the stream has failed
+ * A length field is checked against this before anything is allocated for it, so a corrupt
+ * or truncated file fails the read instead of requesting gigabytes.
+ */
+inline uint64_t remaining_bytes(std::ifstream& in) {
+    const std::streampos position = in.tellg();
+    if (position < 0 || !in.seekg(0, std::ios::end)) return 0;
+    const std::streampos end = in.tellg();
+    in.seekg(position);
+    return end > position ? static_cast<uint64_t>(end - position) : 0;
+}
+
+inline void write_string(std::ofstream& out, const std::string& value) {
+    write_value(out, static_cast<uint64_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+inline bool read_string(std::ifstream& in, std::string& value) {
+    uint64_t size = 0;
+    if (!read_value(in, size) || size > (1u << 20) || size > remaining_bytes(in)) return false;
+    value.resize(size);
+    return static_cast<bool>(in.read(&value[0], static_cast<std::streamsize>(size)));
+}
+
+inline void write_floats(std::ofstream& out, const std::vector<float>& values) {
+    write_value(out, static_cast<uint64_t>(values.size()));
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(float)));
+}
+
+inline bool read_floats(std::ifstream& in, std::vector<float>& values) {
+    uint64_t size = 0;
+    // Far above any vector the engine writes (a window's activity, an embedding)
+    if (!read_value(in, size) || size > (1ull << 24) || size * sizeof(float) > remaining_bytes(in)) return false;
+    values.resize(size);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()), 
+                                     static_cast<std::streamsize>(size * sizeof(float))));
+}
+
+/**
+ * Move a fully written temporary file over its target, so readers never see a partial file
+ * @return true on success; the temporary file is removed on failure
+ */
+inline bool replace_file(const std::string& temp_path, const std::string& path) {
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace BinaryIO
@@ -0,0 +1,49 @@
+// src/native/diarization/include/cpu-affinity.h
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * CPU placement of pipeline stages
+ * A stage's core set pins both the ONNX Runtime intra-op pool (one core per pool thread via
+ * session.intra_op_thread_affinities) and the pipeline thread that drives it, which is pool
+ * thread 0. Pinning the pipeline thread before a model is loaded or a buffer is first written
+ * makes Linux's first-touch policy place those pages on the stage's NUMA node.
+ */
+namespace CpuAffinity {
+    /**
+     * Parse a Linux cpulist such as "0-7,16-23"
+     * @return Core ids in list order, empty if the list is malformed
+     */
+    std::vector<int> parse_cpu_list(const std::string& list);
+    
+    /**
+     * Format core ids as a cpulist ("0-3,8")
+     */
+    std::string format_cpu_list(const std::vector<int>& cores);
+    
+    /**
+     * Cores of a NUMA node, from /sys/devices/system/node/node<N>/cpulist (empty if unknown)
+     */
+    std::vector<int> numa_node_cpus(int node);
+    
+    /**
+     * Core set of a stage: the explicit cpulist, else the NUMA node's cores, else none (unpinned)
+     */
+    std::vector<int> stage_cores(const std::string& list, int numa_node);
+    
+    /**
+     * ONNX Runtime intra_op_thread_affinities for a pool of the given size
+     * Thread 0 is the caller, so the string pins threads 1..threads-1, one core each,
+     * to cores[1..] (wrapping around when the pool is larger than the core set).
+     * Core ids are 1-based in this ORT setting.
+     */
+    std::string ort_thread_affinities(const std::vector<int>& cores, int threads);
+    
+    /**
+     * Restrict the calling thread to a core set
+     * @return false if pinning is unsupported or was refused
+     */
+    bool pin_current_thread(const std::vector<int>& cores);
+}
@@ -0,0 +1,72 @@
+// src/native/diarization/include/deadline-governor.h
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * DeadlineGovernor keeps a job within a wall-clock budget by degrading quality step by step
+ * The pipeline reports measured throughput after each unit of work (segmentation window,
+ * embedded track); once the projected finish time exceeds the budget, the governor enables
+ * the next cheaper setting, least harmful first:
+ *
+ *   segmentation: skip silent windows -> larger hop (less window overlap) -> no embeddings
+ *   embedding:    one crop per track -> label the remaining tracks without embeddings
+ *
+ * Steps are never undone within a job; every applied step is recorded for the output metadata.
+ */
+class DeadlineGovernor {
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    double deadline_;                    // Budget in seconds, <= 0 = no deadline
+    bool verbose_;
+    Clock::time_point start_;
+    
+    bool skip_silence_;
+    float hop_scale_;
+    bool fewer_crops_;
+    bool skip_embeddings_;
+    std::vector<std::string> applied_;
+
+public:
+    explicit DeadlineGovernor(double deadline_seconds = 0.0, bool verbose = false);
+    
+    bool active() const { return deadline_ > 0.0; }
+    double elapsed() const;
+    double remaining() const;
+    
+    /**
+     * Re-plan segmentation from its measured throughput
+     * @param windows_done Windows segmented so far in this run
+     * @param seconds Time spent on them
+     * @param windows_left Windows still to segment at the current settings
+     * @param silent_fraction Fraction of the remaining windows that are silent
+     * @param embeddings_pending Whether an embedding stage still follows
+     */
+    void plan_segmentation(size_t windows_done, double seconds, size_t windows_left,
+                           double silent_fraction, bool embeddings_pending);
+    
+    /**
+     * Re-plan embedding from its measured throughput
+     * @param tracks_done Tracks embedded so far
+     * @param seconds Time spent on them
+     * @param tracks_left Tracks still to embed
+     */
+    void plan_embedding(size_t tracks_done, double seconds, size_t tracks_left);
+    
+    bool skip_silence() const { return skip_silence_; }
+    float hop_scale() const { return hop_scale_; }
+    bool fewer_crops() const { return fewer_crops_; }
+    bool skip_embeddings() const { return skip_embeddings_; }
+    
+    /**
+     * Degradation steps applied so far, in order
+     */
+    const std::vector<std::string>& applied() const { return applied_; }
+
+private:
+    void apply(const std::string& step, double projected, double budget);
+};
@@ -4,12 +4,66 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <atomic>
+#include "stage-profiler.h"
+
+// Position on the audio timeline, counted in samples at DiarizeOptions::sample_rate.
+// Boundaries stay on this integer grid through the whole pipeline and are only
+// converted to seconds when results are printed or serialized.
+using SampleIndex = int64_t;
 
 struct DiarizeOptions {
     std::string audio_path;
     std::string segment_model_path;
     std::string embedding_model_path;
     std::string output_format = "json";
+    std::string mode = "standard";  // standard (powerset tracks + embeddings), fast (no embeddings),
+                                    // uniform (fixed windows, no segmentation) or changepoint
+    int embedding_batch_size = 32;  // Segments per embedding model run where batching applies
+    std::string preset = "balanced";  // Speed/accuracy preset the knobs below start from
+    int intra_op_threads = 4;       // ONNX Runtime intra-op threads per model
+    std::string provider = "cpu";   // CPU execution provider of both models: cpu, xnnpack or dnnl
+    std::string segmentation_provider;  // Per-model provider (empty = provider); after initialization,
+    std::string embedding_provider;     // the placement the model got, e.g. "xnnpack+cpu"
+    int segmentation_batch_size = 1;  // Windows per segmentation model run
+    bool thread_spinning = true;    // Let idle ONNX Runtime threads spin (disabled under a CPU quota)
+    bool use_cgroup = true;         // Fit threads and batches to the cgroup v2 CPU and memory limits
+    float memory_fraction = 0.8f;   // Share of the cgroup memory limit the pipeline may use
+    std::string segmentation_cores; // cpulist ("0-7") for the segmentation stage, empty = unpinned
+    std::string embedding_cores;    // cpulist for the embedding stage, empty = unpinned
+    int numa_node = -1;             // Default core set of both stages: this NUMA node's cores
+    double cpu_limit = 0.0;         // Detected CPU quota in cores, 0 = unlimited
+    int64_t memory_limit = 0;       // Detected memory limit in bytes, 0 = unlimited
+    bool autotune = false;          // Benchmark threads and batch sizes, write the per-host cache and exit
+    std::string autotune_cache;     // Per-host tuned settings (default: user cache directory)
+    bool use_autotune_cache = true; // Apply the cached settings unless overridden on the command line
+    bool autotuned = false;         // Settings were taken from the autotune cache
+    float segment_window = 3.2f;    // Segmentation window (seconds)
+    float segment_hop = 1.6f;       // Segmentation hop (seconds)
+    float embedding_duration = 3.0f;  // Embedding model input length (seconds)
+    float min_segment_duration = 2.0f;  // Shortest change-point segment that gets embedded (seconds)
+    float fallback_segment_duration = 25.0f;  // Segment length when no change point is found (seconds)
+    std::string small_embedding_model_path;  // Optional cheap model screening every item first
+    float cascade_margin = 0.1f;    // Re-embed with the full model when the small model's margin is below this
+    std::string state_path;         // Incremental state of a growing recording (standard and fast modes)
+    std::string checkpoint_path;    // Periodic checkpoint of a long job, removed when the job completes
+    float checkpoint_interval = 60.0f;  // Seconds between checkpoints (stretched to keep writes under 1%)
+    bool resume = false;            // Continue from checkpoint_path if it matches the audio
+    int shard_index = -1;           // Time shard handled by this process (with shard_count > 0)
+    int shard_count = 0;            // Number of time shards, 0 = not sharded
+    float shard_overlap = 10.0f;    // Seconds of context shared with each neighbouring shard
+    std::string shard_dir;          // Shared directory for shard results
+    bool merge_shards = false;      // Merge the shard results in shard_dir instead of diarizing
+    std::string spool_dir;          // Serve jobs from this spool directory instead of --audio
+    std::string worker_id;          // Spool worker name (default: host-pid)
+    float spool_lease = 300.0f;     // Seconds without heartbeat before a claimed job is recovered
+    float deadline = 0.0f;          // Processing budget in seconds; cheaper settings kick in to meet it, 0 = off
+    int progress_fd = -1;           // Write JSON-lines progress events to this fd, -1 = off
+    int control_fd = -1;            // Read control messages ("cancel") from this fd, -1 = off
+    bool warmup = false;            // Run dummy batches at initialize() so the first job skips lazy setup (on in spool mode)
+    bool profile = false;           // Time each stage and report it on stderr and in the JSON output
+    std::string allocation_budgets; // "unit=count,..." peak allocations per steady-state call; exceeding fails the run
     int max_speakers = 10;
     float threshold = 0.5f;
     int sample_rate = 16000;
@@ -19,41 +73,169 @@ struct DiarizeOptions {
 
 struct AudioSegment {
     std::vector<float> samples;
-    float start_time;
-    float end_time;
+    SampleIndex start_sample;
+    SampleIndex end_sample;
     int speaker_id;
     float confidence;
     std::string text; // For integration with transcription
 };
 
+// Work counters of one process_audio call, reported with the results
+struct DiarizeStats {
+    size_t embedding_runs = 0;      // Embedding model runs (a batch counts once)
+    size_t cascade_items = 0;       // Items assigned through the embedding cascade
+    size_t cascade_escalated = 0;   // Of those, items re-embedded with the full model
+    bool cancelled = false;         // The job was cancelled and the results are partial
+    SampleIndex processed_samples = 0;  // Audio covered by the (possibly partial) results
+    double deadline_seconds = 0.0;  // Requested processing budget, 0 = none
+    double elapsed_seconds = 0.0;   // Processing time (set with a deadline)
+    std::vector<std::string> degradations;  // Quality trade-offs applied to meet the deadline
+    std::vector<ProfileStage> profile;  // Stage times with --profile, with model load and warm-up except in spool jobs
+    std::vector<ProfileUnit> profile_units;  // Allocations per steady-state call with --profile
+};
+
 // Forward declarations
 class SpeakerSegmenter;
 class SpeakerEmbedder;
+class SpeakerTracker;
+struct SpeakerTrack;
+class EmbeddingCascade;
+class DiarizeState;
+class AudioBuffer;
+class CheckpointSchedule;
+struct WindowActivity;
+class ProgressReporter;
+class DeadlineGovernor;
 
 class DiarizationEngine {
 private:
     std::unique_ptr<SpeakerSegmenter> segmenter_;
     std::unique_ptr<SpeakerEmbedder> embedder_;
-    std::vector<std::vector<float>> speaker_embeddings_;
-    std::vector<int> speaker_counts_;
+    std::unique_ptr<SpeakerEmbedder> small_embedder_;  // Optional first stage of the cascade
+    std::unique_ptr<EmbeddingCascade> cascade_;
+    std::unique_ptr<CheckpointSchedule> checkpoint_;  // Set while a checkpointed job runs
+    std::unique_ptr<DeadlineGovernor> deadline_;      // Budget of the current job (inactive without --deadline)
+    std::vector<uint8_t> reduced_embeddings_;         // Tracks of the current job embedded with fewer crops (not persisted)
     bool verbose_;
+    size_t embedding_run_base_;  // Embedder inference count when the current job started
+    DiarizeStats stats_;
+    std::vector<int> segmentation_cores_;  // Stage placement, empty = unpinned
+    std::vector<int> embedding_cores_;
+    std::atomic<bool> cancelled_;  // Set from another thread; pipelines stop at the next window
+    ProgressReporter* progress_;   // Optional progress event sink (not owned)
+    StageProfiler* profiler_;      // Optional stage timer (not owned)
 
 public:
     explicit DiarizationEngine(bool verbose = false);
     ~DiarizationEngine();
     
-    bool initialize(const std::string& segment_model_path, const std::string& embedding_model_path);
-    std::vector<AudioSegment> process_audio(const std::vector<float>& audio, const DiarizeOptions& options);
+    // An empty model path skips that model: no embedder for fast mode, no segmenter for uniform mode
+    // A small embedding model path enables the two-model cascade
+    bool initialize(const std::string& segment_model_path, 
+                    const std::string& embedding_model_path,
+                    const std::string& small_embedding_model_path = "",
+                    float cascade_margin = 0.1f);
+    
+    // Same, with model paths and runtime knobs (threads, window, hop, embedding length) from the options
+    bool initialize(const DiarizeOptions& options);
+    std::vector<AudioSegment> process_audio(const AudioBuffer& audio, const DiarizeOptions& options);
+    
+    // Embedding model runs made by the last process_audio call
+    size_t get_embedding_runs() const;
+    
+    // Speaker centroids of the last process_audio call (empty without an embedding model)
+    std::vector<std::vector<float>> get_speaker_centroids() const;
+    
+    // Work counters of the last process_audio call
+    const DiarizeStats& get_stats() const { return stats_; }
+    
+    // Stop the running job at the next window boundary, aborting in-flight inference.
+    // Safe to call from another thread; the engine stays cancelled afterwards.
+    void cancel();
+    bool is_cancelled() const { return cancelled_; }
+    
+    // Execution provider placement of the loaded models ("cpu", "xnnpack", "xnnpack+cpu", ...)
+    std::string segmentation_provider() const;
+    std::string embedding_provider() const;
+    
+    // Pin the calling thread to a stage's cores, so buffers it first touches land on that stage's NUMA node
+    void pin_to_segmentation_cores();
+    void pin_to_embedding_cores();
+    
+    // Report stage progress to this sink while processing (nullptr = off)
+    void set_progress(ProgressReporter* progress) { progress_ = progress; }
+    
+    // Time stages into this profiler, from initialize() on (nullptr = off)
+    void set_profiler(StageProfiler* profiler) { profiler_ = profiler; }
+    
+    // Time a stage that runs outside the engine, such as audio decoding (no-op without a profiler)
+    void begin_profile_stage(const std::string& stage) { if (profiler_) profiler_->begin(stage); }
+    void end_profile_stage() { if (profiler_) profiler_->end(); }
+    
+    // Drop the profile so far, so the next job reports only its own stages
+    void reset_profile() { if (profiler_) profiler_->reset(); }
 
 private:
-    std::vector<float> detect_speaker_changes(const std::vector<float>& audio, const DiarizeOptions& options);
-    std::vector<AudioSegment> create_segments(const std::vector<float>& audio, 
-                                            const std::vector<float>& change_points,
+    void update_stats();
+    
+    // Enter a pipeline stage: progress event and profiler timing
+    void begin_stage(const std::string& stage);
+    
+    // Run every model once at the batch shapes the options will use, so that lazy kernel
+    // initialization and arena growth do not land on the first window of the first job
+    void warm_up(const DiarizeOptions& options);
+    
+    // Powerset pipeline: local speaker tracks, one embedding per track
+    std::vector<AudioSegment> diarize_tracks(const AudioBuffer& audio, const DiarizeOptions& options);
+    SampleIndex track_speakers(const AudioBuffer& audio, const DiarizeOptions& options,
+                               SpeakerTracker& tracker, DiarizeState& state);
+    void label_tracks(const std::vector<SpeakerTrack>& tracks,
+                      const DiarizeOptions& options,
+                      std::vector<int>& track_speaker_ids,
+                      std::vector<float>& track_confidence);
+    std::vector<std::vector<float>> track_crops(const AudioBuffer& audio,
+                                                const SpeakerTrack& track,
+                                                const SpeakerTracker& tracker,
+                                                const std::vector<uint8_t>& active_tracks,
+                                                size_t target_length,
+                                                size_t max_crops);
+    std::vector<AudioSegment> tracks_to_segments(const std::vector<SpeakerTrack>& tracks,
+                                                 const SpeakerTracker& tracker,
+                                                 const std::vector<int>& track_speaker_ids,
+                                                 const std::vector<float>& track_confidence,
+                                                 SampleIndex total_samples,
+                                                 const DiarizeOptions& options);
+    
+    // Incremental state of a growing recording and checkpoints of long jobs
+    DiarizeState state_settings(const DiarizeOptions& options) const;
+    bool read_state(const std::string& path, const AudioBuffer& audio,
+                    const DiarizeOptions& options, bool exact, DiarizeState& state);
+    bool load_state(const AudioBuffer& audio, const DiarizeOptions& options, DiarizeState& state);
+    void save_state(const AudioBuffer& audio, const DiarizeOptions& options,
+                    const SpeakerTracker& tracker,
+                    const std::vector<std::vector<float>>* embeddings,
+                    DiarizeState& state,
+                    const std::string& path,
+                    bool stable_only);
+    void write_checkpoint(const AudioBuffer& audio, const DiarizeOptions& options,
+                          const SpeakerTracker& tracker,
+                          const std::vector<std::vector<float>>* embeddings,
+                          DiarizeState& state);
+    void finish_state(const AudioBuffer& audio, const DiarizeOptions& options,
+                      const SpeakerTracker& tracker,
+                      const std::vector<std::vector<float>>& embeddings,
+                      DiarizeState& state);
+    void discard_checkpoint(const DiarizeOptions& options);
+    
+    // Uniform-window pipeline: batched embeddings of fixed windows, no segmentation model
+    std::vector<AudioSegment> diarize_uniform(const AudioBuffer& audio, const DiarizeOptions& options);
+    
+    // Change-point pipeline
+    std::vector<SampleIndex> detect_speaker_changes(const AudioBuffer& audio, const DiarizeOptions& options);
+    std::vector<AudioSegment> create_segments(const AudioBuffer& audio, 
+                                            const std::vector<SampleIndex>& change_points,
                                             const DiarizeOptions& options);
     std::vector<AudioSegment> assign_speakers(std::vector<AudioSegment>& segments, const DiarizeOptions& options);
-    int find_or_create_speaker(const std::vector<float>& embedding, float threshold, int max_speakers);
-    float calculate_confidence(const std::vector<float>& embedding, int speaker_id);
-    float cosine_similarity(const std::vector<float>& a, const std::vector<float>& b);
 };
 
 // Utility functions
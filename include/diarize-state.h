@@ -0,0 +1,122 @@
+// src/native/diarization/include/diarize-state.h
+#pragma once
+
+#include "powerset-decoder.h"
+#include "audio-buffer.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+
+/**
+ * Embedding of one speaker track, valid while the track is built from the same windows
+ */
+struct TrackEmbedding {
+    int track_id = -1;
+    int64_t first_frame = 0;
+    uint64_t window_count = 0;
+    std::vector<float> embedding;
+};
+
+/**
+ * Resumable diarization state of a recording that keeps growing
+ * Holds the decoded segmentation windows that lie fully inside the audio seen so far
+ * and the embeddings of tracks that ended before the last of those windows. A later run
+ * on a longer recording replays the windows into the tracker, reuses the embeddings of
+ * unchanged tracks and only runs the models on the new tail; clustering is redone from
+ * the cached embeddings, which is cheap.
+ */
+class DiarizeState {
+public:
+    // Settings the cached results depend on
+    std::string mode;
+    std::string embedding_model;
+    float embedding_duration = 0.0f;
+    int32_t sample_rate = 0;
+    int64_t window_size = 0;
+    int64_t hop_size = 0;
+    
+    // Audio prefix the state was computed from
+    int64_t audio_samples = 0;
+    uint64_t prefix_hash = 0;     // hash_prefix() of the first audio_samples samples
+    
+    std::vector<WindowActivity> windows;           // Stable segmentation windows, in start order
+    std::vector<TrackEmbedding> track_embeddings;  // Embeddings of tracks that can no longer grow
+    
+    /**
+     * Write the state to a binary file, replacing it atomically
+     * @param path Output path
+     * @return true on success
+     */
+    bool save(const std::string& path) const;
+    
+    /**
+     * Read a state file written by save()
+     * @param path Input path
+     * @return true on success; the state is left empty on failure
+     */
+    bool load(const std::string& path);
+    
+    /**
+     * Check that this state was computed from a prefix of the given audio with the same settings
+     * @param audio Current audio
+     * @param settings State holding only the current settings
+     * @param exact Require the state to cover the whole audio (checkpoints of the same job)
+     * @param reason Set to a short explanation when the state does not apply
+     */
+    bool applies_to(const AudioBuffer& audio, const DiarizeState& settings, bool exact, std::string& reason) const;
+    
+    /**
+     * Fingerprint of the first samples of a recording: FNV-1a over its first and last
+     * kCheckSamples samples and its length
+     * The cost is bounded, so checking a state stays proportional to the new audio however long
+     * the recording grows. Appended audio and a replaced recording are detected; an edit in the
+     * middle of a long recording is not.
+     */
+    static uint64_t hash_prefix(const AudioBuffer& audio, size_t samples);
+    
+    static constexpr size_t kCheckSamples = 1 << 18;  // ~16s at 16 kHz
+    
+    /**
+     * Find a cached embedding for a track built from the same windows
+     * @return Pointer to the embedding, or nullptr
+     */
+    const std::vector<float>* find_embedding(int track_id, int64_t first_frame, uint64_t window_count) const;
+};
+
+/**
+ * Decides when a long job writes its next checkpoint
+ * Checkpoints are spaced by wall-clock time; if writing one takes more than the overhead
+ * budget of the interval, the interval is stretched so checkpointing stays under budget.
+ */
+class CheckpointSchedule {
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    double interval_seconds_;
+    double overhead_budget_;      // Fraction of runtime checkpoint writes may take
+    Clock::time_point last_write_;
+    size_t write_count_;
+    double write_seconds_;        // Total time spent writing checkpoints
+
+public:
+    explicit CheckpointSchedule(double interval_seconds = 60.0, double overhead_budget = 0.01);
+    
+    /**
+     * Check whether the next checkpoint is due
+     */
+    bool due() const;
+    
+    /**
+     * Record a checkpoint write that started at the given time
+     */
+    void record_write(Clock::time_point started);
+    
+    /**
+     * Start timing a checkpoint write
+     */
+    static Clock::time_point now() { return Clock::now(); }
+    
+    size_t write_count() const { return write_count_; }
+    double write_seconds() const { return write_seconds_; }
+};
@@ -0,0 +1,70 @@
+// src/native/diarization/include/embedding-cascade.h
+#pragma once
+
+#include "speaker-embedder.h"
+#include <vector>
+#include <functional>
+
+/**
+ * EmbeddingCascade assigns speakers with a small embedding model and escalates only
+ * ambiguous decisions to the full model
+ * Both embedders keep centroids in a shared speaker ID space. The small model sees every
+ * item; when its decision margin is below the cascade margin, the item is re-embedded with
+ * the large model and decided there. Large-model centroids are built lazily: a speaker first
+ * gets one when an escalation needs it, from the item that created the speaker.
+ */
+class EmbeddingCascade {
+public:
+    // Produces the audio crops of one item for a model input length, on demand
+    using CropSource = std::function<std::vector<std::vector<float>>(size_t target_length)>;
+
+private:
+    SpeakerEmbedder& small_;
+    SpeakerEmbedder& large_;
+    float margin_;                        // Escalate when the small-model decision margin is below this
+    bool verbose_;
+    
+    std::vector<CropSource> anchors_;     // Item that created each speaker
+    size_t assigned_count_;
+    size_t escalated_count_;
+
+public:
+    EmbeddingCascade(SpeakerEmbedder& small, SpeakerEmbedder& large, float margin, bool verbose = false);
+    
+    /**
+     * Assign one item to a speaker
+     * @param small_embedding Embedding of the item from the small model
+     * @param crops Crop source for the item, only called on escalation; must stay valid until reset()
+     * @param threshold Similarity threshold for speaker matching
+     * @param max_speakers Maximum number of speakers to track
+     * @return Speaker ID (0-based)
+     */
+    int assign(const std::vector<float>& small_embedding, const CropSource& crops,
+               float threshold, int max_speakers);
+    
+    /**
+     * Items assigned since the last reset
+     */
+    size_t assigned_count() const { return assigned_count_; }
+    
+    /**
+     * Items re-embedded with the large model since the last reset
+     */
+    size_t escalated_count() const { return escalated_count_; }
+    
+    /**
+     * Drop speakers of both embedders and all anchors
+     */
+    void reset();
+
+private:
+    /**
+     * Distance of a match from the nearest other decision (another speaker or a new speaker)
+     */
+    static float decision_margin(const SpeakerMatch& match, float threshold);
+    
+    /**
+     * Give every known speaker a large-model centroid from its anchor
+     */
+    void anchor_large_speakers();
+};
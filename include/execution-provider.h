@@ -0,0 +1,46 @@
+// src/native/diarization/include/execution-provider.h
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <onnxruntime_cxx_api.h>
+
+/**
+ * CPU execution providers selectable with --provider
+ * cpu is ONNX Runtime's default provider. xnnpack and dnnl (oneDNN) are only present in ONNX
+ * Runtime builds that include them; nodes they cannot run stay on the default provider.
+ */
+namespace ExecutionProvider {
+    /**
+     * Provider names accepted by --provider
+     */
+    const std::vector<std::string>& names();
+    
+    /**
+     * Model file to load: <name>.ort next to <name>.onnx when it is at least as new as the
+     * .onnx, as ORT format models load without graph parsing and optimization; a stale .ort is
+     * ignored. The minimal runtime loads nothing else, so there the .ort is always used.
+     * @throws std::runtime_error in a DIARIZATION_MINIMAL_ORT build when there is no .ort file
+     */
+    std::string model_file(const std::string& model_path);
+    
+    /**
+     * Whether the linked ONNX Runtime build includes a provider (cpu always does)
+     */
+    bool is_available(const std::string& name);
+    
+    /**
+     * Create a session on a provider, with fallback
+     * The model is first loaded with CPU fallback disabled, which only succeeds if the provider
+     * supports every node. Otherwise it is loaded again with unsupported nodes on the default
+     * provider, and if the provider is missing or fails, on the default provider alone.
+     * @param base Session options without a provider
+     * @param provider cpu, xnnpack or dnnl
+     * @param threads Intra-op threads, also used for a provider's own thread pool
+     * @param used Receives the placement: "xnnpack" (every node), "xnnpack+cpu" (per-node fallback) or "cpu"
+     */
+    std::unique_ptr<Ort::Session> create_session(Ort::Env& env, const std::string& model_path,
+                                                 const Ort::SessionOptions& base, const std::string& provider,
+                                                 int threads, std::string& used, bool verbose = false);
+}
@@ -0,0 +1,88 @@
+// src/native/diarization/include/job-control.h
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+class DiarizationEngine;
+
+/**
+ * ProgressReporter writes machine-readable progress events, one JSON object per line
+ *
+ *   {"event":"stage","stage":"segmentation"}
+ *   {"event":"progress","stage":"segmentation","fraction":0.420,"elapsed_seconds":4.1,"eta_seconds":5.7}
+ *   {"event":"done","segments":42}     (or "cancelled" with the partial result's segment count)
+ *
+ * Progress events are rate-limited; a disabled reporter (fd < 0) ignores every call.
+ */
+class ProgressReporter {
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    int fd_;
+    std::string stage_;
+    Clock::time_point stage_start_;
+    Clock::time_point last_emit_;
+    double last_fraction_;
+
+public:
+    explicit ProgressReporter(int fd = -1);
+    
+    bool enabled() const { return fd_ >= 0; }
+    
+    /**
+     * Start a pipeline stage (segmentation, embedding, clustering)
+     */
+    void begin_stage(const std::string& stage);
+    
+    /**
+     * Report progress of the current stage
+     * @param fraction Completed fraction in [0, 1]
+     */
+    void update(double fraction);
+    
+    /**
+     * Report the end of the job
+     * @param status "done", "cancelled" or "failed"
+     * @param segments Number of segments in the (possibly partial) result
+     */
+    void finish(const std::string& status, size_t segments);
+
+private:
+    void emit(const std::string& line);
+};
+
+/**
+ * JobControl forwards cancellation requests to a running engine
+ * Requests come from signals (request_cancel() is async-signal-safe) or from "cancel" lines
+ * on a control fd. A watcher thread turns them into DiarizationEngine::cancel(), which aborts
+ * the in-flight inference and makes the pipeline stop at the next window boundary.
+ */
+class JobControl {
+private:
+    DiarizationEngine& engine_;
+    int control_fd_;
+    std::atomic<bool> stop_;
+    std::thread watcher_;
+    
+    static std::atomic<bool> cancel_requested_;
+
+public:
+    JobControl(DiarizationEngine& engine, int control_fd = -1);
+    ~JobControl();
+    
+    JobControl(const JobControl&) = delete;
+    JobControl& operator=(const JobControl&) = delete;
+    
+    /**
+     * Request cancellation of the current job (async-signal-safe)
+     */
+    static void request_cancel() { cancel_requested_ = true; }
+    
+    static bool cancel_requested() { return cancel_requested_; }
+
+private:
+    void watch();
+};
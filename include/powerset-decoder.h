@@ -0,0 +1,57 @@
+// src/native/diarization/include/powerset-decoder.h
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Per-window local speaker activity decoded from the segmentation model
+ * Local speaker indices are only meaningful inside one window
+ */
+struct WindowActivity {
+    int64_t start_sample = 0;     // First sample covered by the window
+    size_t num_frames = 0;        // Number of output frames
+    size_t num_speakers = 0;      // Number of local speakers
+    std::vector<float> activity;  // Frame-major [num_frames x num_speakers], values in [0, 1]
+
+    float at(size_t frame, size_t speaker) const { return activity[frame * num_speakers + speaker]; }
+};
+
+/**
+ * PowersetDecoder converts pyannote powerset logits into per-speaker activity
+ * segmentation-3.0 predicts one class per frame out of every set of up to
+ * max_simultaneous active speakers: {}, {0}, {1}, {2}, {0,1}, {0,2}, {1,2}
+ */
+class PowersetDecoder {
+private:
+    size_t num_speakers_;
+    size_t max_simultaneous_;
+    std::vector<std::vector<size_t>> class_speakers_;  // Active local speakers per powerset class
+    bool segmentation3_;  // 3 speakers, at most 2 at once: decoded by the fixed-shape kernel
+
+public:
+    explicit PowersetDecoder(size_t num_speakers = 3, size_t max_simultaneous = 2);
+
+    /**
+     * Number of powerset classes the decoder expects
+     */
+    size_t num_classes() const { return class_speakers_.size(); }
+
+    /**
+     * Number of local speakers produced per frame
+     */
+    size_t num_speakers() const { return num_speakers_; }
+
+    /**
+     * Decode one window of logits into soft per-speaker activity
+     * Each speaker's activity is the total softmax probability of the classes containing it,
+     * so overlapping speech yields two active speakers on the same frame. The segmentation-3.0
+     * layout (7 classes, 3 speakers) runs a kernel with the class table built in, unrolled for
+     * 186-frame windows; other layouts and frame counts take the generic loop.
+     * @param logits Frame-major logits [num_frames x num_classes()]
+     * @param num_frames Number of frames in the window
+     * @param activity Output buffer [num_frames x num_speakers()]
+     */
+    void decode(const float* logits, size_t num_frames, float* activity) const;
+};
@@ -0,0 +1,39 @@
+// src/native/diarization/include/presets.h
+#pragma once
+
+#include "diarize-cli.h"
+#include <string>
+
+/**
+ * A coherent set of speed/accuracy knobs selected with --preset
+ * Presets are applied before the other options, so every knob can still be overridden.
+ */
+struct Preset {
+    const char* name;
+    int intra_op_threads;            // ONNX Runtime intra-op threads per model
+    float segment_window;            // Segmentation window (seconds)
+    float segment_hop;               // Segmentation hop (seconds)
+    float embedding_duration;        // Embedding model input length (seconds)
+    int embedding_batch_size;        // Segments per embedding model run
+    float min_segment_duration;      // Shortest change-point segment that gets embedded (seconds)
+    float fallback_segment_duration; // Segment length without change points (seconds)
+};
+
+namespace Presets {
+    /**
+     * Look up a preset by name
+     * @return The preset, or nullptr for an unknown name
+     */
+    const Preset* find(const std::string& name);
+    
+    /**
+     * Copy a preset's knobs into the options
+     * @return false for an unknown preset name
+     */
+    bool apply(const std::string& name, DiarizeOptions& options);
+    
+    /**
+     * Preset names separated by '|', for help and error messages
+     */
+    std::string names();
+}
@@ -0,0 +1,60 @@
+// src/native/diarization/include/resource-governor.h
+#pragma once
+
+#include "diarize-cli.h"
+#include <string>
+#include <cstdint>
+
+/**
+ * CPU and memory limits of the container the process runs in
+ */
+struct ResourceLimits {
+    double cpus = 0.0;            // CPU quota in cores (cpu.max), 0 = unlimited
+    int64_t memory_bytes = 0;     // Memory limit (memory.max), 0 = unlimited
+    int64_t memory_used = 0;      // Memory charged to the cgroup at startup (memory.current)
+    std::string cgroup;           // cgroup v2 path the limits were read from
+    
+    bool limited() const { return cpus > 0.0 || memory_bytes > 0; }
+};
+
+/**
+ * ResourceGovernor sizes thread pools and batches to the cgroup v2 limits of the process
+ * ONNX Runtime sizes its pools from the host's cores, not from the pod's CPU quota, and the
+ * hard-coded thread counts ignore it too: a 2-CPU pod on a 64-core node gets throttled and
+ * spinning worker threads burn its quota. Batch sizes and the uniform-mode chunk are capped so
+ * their working set stays under a fraction of memory.max, minus what is already charged.
+ */
+class ResourceGovernor {
+private:
+    ResourceLimits limits_;
+    float memory_fraction_;
+    bool verbose_;
+
+public:
+    ResourceGovernor(const ResourceLimits& limits, float memory_fraction, bool verbose = false);
+    
+    /**
+     * Read the limits of this process's cgroup (Linux, cgroup v2); unlimited elsewhere
+     * Limits of parent cgroups apply too, so the tightest one along the path wins.
+     */
+    static ResourceLimits detect();
+    
+    /**
+     * Cap threads and batch sizes in the options to the limits
+     * @param audio_seconds Length of the audio to hold in memory, 0 if not known yet
+     */
+    void apply(DiarizeOptions& options, double audio_seconds = 0.0) const;
+    
+    /**
+     * Memory the pipeline may use beyond what is charged at startup (0 = unlimited)
+     */
+    int64_t memory_budget() const;
+    
+    const ResourceLimits& limits() const { return limits_; }
+
+private:
+    /**
+     * Largest item count whose working set fits a share of the memory budget (at least 1)
+     */
+    int max_items(int64_t bytes_per_item, double budget_share, int current) const;
+};
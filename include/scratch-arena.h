@@ -0,0 +1,59 @@
+// src/native/diarization/include/scratch-arena.h
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+/**
+ * ScratchArena hands out 64-byte aligned scratch buffers for model inputs and outputs
+ * Buffers are bump-allocated from a block and live until reset(), which rewinds the arena
+ * without freeing it. When a pass needed more than one block, reset() replaces them with a
+ * single block of the peak size, so after the first window or batch has sized the arena,
+ * steady-state processing takes no memory from the heap.
+ */
+class ScratchArena {
+private:
+    static constexpr size_t kAlignment = 64;
+    
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        unsigned char* begin = nullptr;  // memory aligned to kAlignment
+        size_t size = 0;
+        size_t used = 0;
+    };
+    
+    std::vector<Block> blocks_;
+    size_t min_block_size_;
+    size_t in_use_;           // Bytes handed out since the last reset
+    size_t peak_;             // Largest in_use_ seen
+    size_t block_allocations_;  // Heap allocations made by the arena
+
+public:
+    explicit ScratchArena(size_t min_block_size = 1 << 20);
+    
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+    
+    /**
+     * Uninitialized, aligned room for count values of a trivial type, valid until reset()
+     */
+    template <typename T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocate_bytes(count * sizeof(T)));
+    }
+    
+    void* allocate_bytes(size_t bytes);
+    
+    /**
+     * Release every buffer handed out since the last reset
+     */
+    void reset();
+    
+    size_t capacity() const;
+    size_t peak() const { return peak_; }
+    size_t block_allocations() const { return block_allocations_; }
+
+private:
+    void add_block(size_t size);
+};
@@ -0,0 +1,106 @@
+// src/native/diarization/include/shard-merge.h
+#pragma once
+
+#include "diarize-cli.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/**
+ * Result of diarizing one time shard of a recording
+ * A shard processes its core range plus an overlap on each side. Segments are on the
+ * global sample timeline but carry shard-local speaker IDs; the centroids let the merge
+ * step recognize the same speaker in shards that do not overlap.
+ */
+struct ShardResult {
+    int32_t shard_index = 0;
+    int32_t shard_count = 1;
+    int32_t sample_rate = 16000;
+    int64_t core_start = 0;        // First sample this shard is authoritative for
+    int64_t core_end = 0;          // One past the last authoritative sample
+    int64_t range_start = 0;       // First sample processed (core minus overlap)
+    int64_t range_end = 0;         // One past the last processed sample (core plus overlap)
+    std::vector<AudioSegment> segments;
+    std::vector<std::vector<float>> centroids;  // Per local speaker, empty without an embedding model
+    
+    /**
+     * Compute core and processed ranges of one shard
+     * @param total_samples Length of the recording
+     * @param index Shard index in [0, count)
+     * @param count Number of shards
+     * @param overlap Samples of context added on each side of the core range
+     */
+    void set_range(int64_t total_samples, int index, int count, int64_t overlap);
+    
+    /**
+     * Number of local speakers (from centroids and segment labels)
+     */
+    size_t local_speaker_count() const;
+    
+    /**
+     * Path of a shard file inside the shared shard directory
+     */
+    static std::string file_path(const std::string& shard_dir, int index);
+    
+    /**
+     * Write the shard result, replacing the file atomically
+     */
+    bool save(const std::string& path) const;
+    
+    /**
+     * Read a shard result written by save()
+     */
+    bool load(const std::string& path);
+};
+
+/**
+ * ShardMerger links shard-local speakers into global speakers
+ * Consecutive shards are linked by how well their speakers' segments agree on the shared
+ * overlap, combined with centroid similarity; speakers absent from an overlap are matched
+ * to earlier global speakers by centroid similarity alone. Each shard then contributes the
+ * segments of its core range, relabeled with global speaker IDs.
+ */
+class ShardMerger {
+private:
+    float threshold_;                          // Minimum centroid similarity for a match
+    int max_speakers_;
+    bool verbose_;
+    
+    std::vector<std::vector<float>> global_centroids_;  // Empty for speakers seen without embeddings
+    std::vector<int> global_counts_;
+
+public:
+    ShardMerger(float threshold, int max_speakers, bool verbose = false);
+    
+    /**
+     * Merge complete, ordered shard results into one diarization
+     * @param shards Shard results for indices 0..count-1, in order
+     * @return Segments with global speaker IDs, sorted by start
+     * @throws std::runtime_error if a segment has a speaker ID outside its shard's speakers
+     */
+    std::vector<AudioSegment> merge(const std::vector<ShardResult>& shards);
+    
+    /**
+     * Number of global speakers after merge()
+     */
+    size_t speaker_count() const { return global_centroids_.size(); }
+
+private:
+    /**
+     * Map the local speakers of a shard to global speakers
+     */
+    std::vector<int> link_shard(const ShardResult* previous, const std::vector<int>& previous_labels,
+                                const ShardResult& shard);
+    
+    /**
+     * Dice agreement of two speakers' speech inside a region: 2|A∩B| / (|A| + |B|)
+     */
+    static float overlap_agreement(const ShardResult& a, int speaker_a,
+                                   const ShardResult& b, int speaker_b,
+                                   int64_t region_start, int64_t region_end);
+    
+    /**
+     * Fold a local centroid into a global speaker
+     */
+    void add_centroid(int global_id, const std::vector<float>& centroid);
+};
@@ -0,0 +1,126 @@
+// src/native/diarization/include/signal-filters.h
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * Linear-time filters over frame sequences (probabilities, activities)
+ * Each filter keeps its own state, so a sequence can be fed in pieces of any size and gives
+ * the same result as one pass over the whole sequence. Indices in the results count from
+ * the first value ever pushed. Memory is bounded by the filter width, not the sequence length,
+ * so hour-long sequences never have to be held in full.
+ */
+namespace Signal {
+    /**
+     * Peak picking under a minimum distance constraint
+     * A value is a peak if it is above the threshold and strictly greater than every other
+     * value within min_distance on both sides. Values closer than min_distance to either end
+     * of the sequence have an incomplete neighbourhood and are never peaks. The neighbourhood
+     * maximum comes from a monotonic deque, so each value is pushed and popped once.
+     */
+    class PeakPicker {
+    private:
+        float threshold_;
+        size_t min_distance_;
+        size_t pushed_;        // Values seen so far
+        
+        // Monotonic deque in a ring of 2d + 1 slots: indices of the last 2d + 1 values
+        // that no later value exceeds, so their values are non-increasing front to back
+        std::vector<size_t> indices_;
+        std::vector<float> values_;
+        size_t head_;
+        size_t size_;
+        
+        size_t slot(size_t i) const { return (head_ + i) % indices_.size(); }
+    
+    public:
+        PeakPicker(float threshold, size_t min_distance);
+        
+        /**
+         * Append values; peaks whose neighbourhood is now complete are appended to peaks
+         */
+        void push(const float* values, size_t count, std::vector<size_t>& peaks);
+        
+        void reset();
+    };
+    
+    /**
+     * Centred running median of an odd width
+     * Near the ends of the sequence the window is cut short rather than padded, and a window
+     * of even length gives the mean of its two middle values. The window is kept sorted, so
+     * each value costs a binary search and a shift of at most width elements: linear in the
+     * sequence length for a fixed width.
+     */
+    class RunningMedian {
+    private:
+        size_t width_;
+        size_t half_;
+        size_t pushed_;
+        size_t emitted_;
+        std::vector<float> ring_;    // Window values in arrival order
+        std::vector<float> sorted_;  // Window values in ascending order
+        
+        void remove_oldest();
+        float median() const;
+    
+    public:
+        explicit RunningMedian(size_t width);
+        
+        /**
+         * Append values; medians of the windows that are now complete are appended to out
+         * Output lags input by width / 2 values.
+         */
+        void push(const float* values, size_t count, std::vector<float>& out);
+        
+        /**
+         * Emit the last width / 2 medians, then start over
+         */
+        void finish(std::vector<float>& out);
+    };
+    
+    /**
+     * Half-open range [start, end) of active values
+     */
+    struct Region {
+        size_t start;
+        size_t end;
+    };
+    
+    /**
+     * Binarization with hysteresis
+     * A region starts on the first value at or above onset and ends on the first value below
+     * offset, so values wavering between the two do not split it. offset should not exceed onset;
+     * with offset == onset this is a plain threshold.
+     */
+    class Hysteresis {
+    private:
+        float onset_;
+        float offset_;
+        size_t pushed_;
+        bool active_;
+        size_t start_;
+    
+    public:
+        Hysteresis(float onset, float offset);
+        
+        /**
+         * Append values; regions that ended within them are appended to regions
+         */
+        void push(const float* values, size_t count, std::vector<Region>& regions);
+        
+        /**
+         * Close a region still open at the end of the sequence, then start over
+         */
+        void finish(std::vector<Region>& regions);
+        
+        bool active() const { return active_; }
+    };
+    
+    /**
+     * One-shot versions over a whole sequence
+     */
+    std::vector<size_t> find_peaks(const float* values, size_t count, float threshold, size_t min_distance);
+    std::vector<float> median_filter(const float* values, size_t count, size_t width);
+    std::vector<Region> binarize(const float* values, size_t count, float onset, float offset);
+}
@@ -0,0 +1,73 @@
+// src/native/diarization/include/simd-kernels.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Vector math kernels shared by the embedder, the clustering code and Utils::Math
+ * Each kernel has a scalar, AVX2+FMA, AVX-512 and NEON version. The best one the CPU supports
+ * is picked on first use (CPUID on x86, NEON is always present on arm64), so one portable
+ * binary runs the widest kernels on every machine. DIARIZATION_KERNELS=scalar|avx2|avx512
+ * forces a set, for comparisons; an unsupported choice falls back to the detected one.
+ * Lengths of 192, 256 and 512 (the embedding sizes of the supported models) run fixed-length
+ * versions without tail handling; any other length takes the generic kernel.
+ */
+namespace SimdKernels {
+    /**
+     * Sum of a[i] * b[i]
+     */
+    float dot(const float* a, const float* b, size_t n);
+    
+    /**
+     * Euclidean length of a
+     */
+    float norm(const float* a, size_t n);
+    
+    /**
+     * Scale a to unit length; vectors shorter than 1e-6 are left as they are
+     */
+    void normalize(float* a, size_t n);
+    
+    /**
+     * a[i] *= alpha
+     */
+    void scale(float* a, float alpha, size_t n);
+    
+    /**
+     * y[i] += alpha * x[i]
+     */
+    void scaled_add(float* y, const float* x, float alpha, size_t n);
+    
+    /**
+     * Largest |a[i]|, 0 for an empty vector
+     */
+    float max_abs(const float* a, size_t n);
+    
+    /**
+     * y[i] = gain * x[i] - coeff * gain * x[i - 1] (x[-1] = 0): gain and pre-emphasis fused
+     * into one copy. With coeff = 0 this is a scaled copy. x and y must not overlap.
+     */
+    void gain_emphasis(float* y, const float* x, float gain, float coeff, size_t n);
+    
+    /**
+     * Largest |a[i]| of 16-bit PCM samples (32768 for -32768), 0 for an empty vector
+     */
+    int32_t max_abs_pcm16(const int16_t* a, size_t n);
+    
+    /**
+     * gain_emphasis reading 16-bit PCM: samples are converted to float on the way, so a window
+     * of the int16 recording goes into the model input in a single pass
+     */
+    void pcm16_emphasis(float* y, const int16_t* x, float gain, float coeff, size_t n);
+    
+    /**
+     * y = M x for a row-major rows x cols matrix
+     */
+    void gemv(const float* matrix, size_t rows, size_t cols, const float* x, float* y);
+    
+    /**
+     * Kernel set in use: "scalar", "avx2", "avx512" or "neon"
+     */
+    const char* isa();
+}
@@ -4,7 +4,18 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <atomic>
 #include <onnxruntime_cxx_api.h>
+#include "scratch-arena.h"
+
+/**
+ * Best and runner-up speaker for an embedding, without touching any centroid
+ */
+struct SpeakerMatch {
+    int speaker_id = -1;        // Closest speaker, -1 if no speakers exist yet
+    float similarity = -1.0f;   // Cosine similarity to the closest speaker
+    float runner_up = -1.0f;    // Cosine similarity to the second closest speaker
+};
 
 /**
  * SpeakerEmbedder extracts speaker embeddings using ONNX models
@@ -22,6 +33,23 @@ private:
     size_t target_length_;    // Fixed input length in samples
     int sample_rate_;         // Expected sample rate
     size_t embedding_dim_;    // Dimension of output embeddings
+    size_t max_batch_size_;   // Largest batch the model accepts (fixed batch dimension or unbounded)
+    size_t inference_count_;  // Model runs since construction
+    
+    // Per-run scratch: model input and output live in the arena, names and shape are cached at load
+    ScratchArena arena_;
+    std::string input_name_;
+    std::string output_name_;
+    std::vector<int64_t> output_shape_;  // Batch dimension rewritten per run; empty if not fully static
+    
+    // Execution provider requested for the next initialize() and the placement it got
+    int intra_op_threads_;
+    std::string provider_;
+    std::string provider_used_;
+    
+    // Cancellation: shared by every Run so an in-flight inference can be aborted
+    Ort::RunOptions run_options_;
+    std::atomic<bool> terminated_;
     
     // Speaker clustering state
     std::vector<std::vector<float>> speaker_centroids_;
@@ -31,6 +59,29 @@ public:
     explicit SpeakerEmbedder(bool verbose = false);
     ~SpeakerEmbedder();
     
+    /**
+     * Set ONNX Runtime intra-op threads; takes effect at the next initialize()
+     * @param threads Intra-op pool size
+     * @param allow_spinning Let idle pool threads spin (off under a CPU quota)
+     */
+    void set_intra_op_threads(int threads, bool allow_spinning = true);
+    
+    /**
+     * Pin intra-op pool threads 1..N-1 (ORT session.intra_op_thread_affinities format, e.g. "3;4;5");
+     * takes effect at the next initialize()
+     */
+    void set_thread_affinities(const std::string& affinities);
+    
+    /**
+     * Select the execution provider (cpu, xnnpack or dnnl); takes effect at the next initialize()
+     */
+    void set_provider(const std::string& provider) { provider_ = provider; }
+    
+    /**
+     * Provider the loaded model runs on: "cpu", "<provider>" or "<provider>+cpu" (per-node fallback)
+     */
+    const std::string& get_provider() const { return provider_used_; }
+    
     /**
      * Initialize the embedder with an ONNX model
      * @param model_path Path to the embedding ONNX model
@@ -47,6 +98,22 @@ public:
      */
     std::vector<float> extract_embedding(const std::vector<float>& audio_segment);
     
+    /**
+     * Extract embeddings for many segments, running the model on batches
+     * @param audio_segments Input audio segments
+     * @param batch_size Segments per model run (capped by the model's batch dimension)
+     * @return One normalized embedding per segment, in input order
+     */
+    std::vector<std::vector<float>> extract_embeddings(const std::vector<std::vector<float>>& audio_segments,
+                                                       size_t batch_size);
+    
+    /**
+     * Embed several crops of one speaker in a single model run and average them
+     * @param crops Audio crops of the same speaker
+     * @return Normalized mean embedding
+     */
+    std::vector<float> extract_mean_embedding(const std::vector<std::vector<float>>& crops);
+    
     /**
      * Find or create speaker ID for given embedding
      * @param embedding Speaker embedding vector
@@ -64,6 +131,42 @@ public:
      */
     float calculate_confidence(const std::vector<float>& embedding, int speaker_id);
     
+    /**
+     * Find the closest existing speaker without updating any centroid
+     * @param embedding Speaker embedding vector
+     * @return Speaker ID, or -1 if no speakers exist yet
+     */
+    int find_closest_speaker(const std::vector<float>& embedding);
+    
+    /**
+     * Score an embedding against all speakers that have a centroid
+     * @param embedding Speaker embedding vector
+     * @return Best and runner-up similarities
+     */
+    SpeakerMatch match_speaker(const std::vector<float>& embedding);
+    
+    /**
+     * Add an embedding to a speaker chosen by the caller
+     * Speaker IDs above the current count are created; IDs skipped over stay without a centroid
+     * until they receive an embedding, so several embedders can share one ID space
+     * @param speaker_id Target speaker ID (0-based)
+     * @param embedding Speaker embedding vector
+     */
+    void add_to_speaker(int speaker_id, const std::vector<float>& embedding);
+    
+    /**
+     * Check whether a speaker ID has a centroid
+     */
+    bool has_speaker(int speaker_id) const {
+        return speaker_id >= 0 && static_cast<size_t>(speaker_id) < speaker_centroids_.size() &&
+               !speaker_centroids_[speaker_id].empty();
+    }
+    
+    /**
+     * Get the centroid of a discovered speaker
+     */
+    const std::vector<float>& get_speaker_centroid(int speaker_id) const { return speaker_centroids_[speaker_id]; }
+    
     /**
      * Get number of discovered speakers
      */
@@ -79,16 +182,43 @@ public:
      */
     bool is_initialized() const { return session_ != nullptr; }
     
+    /**
+     * Abort the running inference and refuse new ones (safe to call from another thread)
+     */
+    void terminate();
+    
+    /**
+     * Allow inference again after terminate()
+     */
+    void clear_terminate();
+    
     /**
      * Get embedding dimension
      */
     size_t get_embedding_dimension() const { return embedding_dim_; }
     
+    /**
+     * Get model input length in samples
+     */
+    size_t get_target_length() const { return target_length_; }
+    
+    /**
+     * Get number of model runs so far (a batch counts once)
+     */
+    size_t get_inference_count() const { return inference_count_; }
+    
 private:
+    /**
+     * Run the model on one batch of segments
+     * @return count * embedding_dim_ raw embeddings in the arena, valid until the next run
+     */
+    float* run_batch(const std::vector<float>* const* segments, size_t count);
+    
     /**
      * Normalize embedding vector to unit length
      */
     void normalize_embedding(std::vector<float>& embedding);
+    void normalize_embedding(float* embedding, size_t length);
     
     /**
      * Calculate cosine similarity between two embeddings
@@ -101,6 +231,11 @@ private:
      */
     std::vector<float> prepare_audio_segment(const std::vector<float>& audio);
     
+    /**
+     * Prepare audio segment directly into a model input row of target_length_ samples
+     */
+    void prepare_audio_segment(const std::vector<float>& audio, float* output);
+    
     /**
      * Update speaker centroid with new embedding
      */
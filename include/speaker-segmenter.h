@@ -4,7 +4,13 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstdint>
+#include <atomic>
 #include <onnxruntime_cxx_api.h>
+#include "powerset-decoder.h"
+#include "scratch-arena.h"
+#include "audio-buffer.h"
+#include "audio-gain.h"
 
 /**
  * SpeakerSegmenter handles speaker change point detection using ONNX models
@@ -22,26 +28,73 @@ private:
     int window_size_;     // Input window size in samples
     int hop_size_;        // Hop size for sliding window
     int sample_rate_;     // Expected sample rate
+    size_t max_batch_size_;  // Largest batch the model accepts (fixed batch dimension or unbounded)
+    
+    // Execution provider requested for the next initialize() and the placement it got
+    int intra_op_threads_;
+    std::string provider_;
+    std::string provider_used_;
+    
+    PowersetDecoder decoder_;  // Powerset classes -> local speaker activity
+    
+    // Cancellation: shared by every Run so an in-flight inference can be aborted
+    Ort::RunOptions run_options_;
+    std::atomic<bool> terminated_;
+    
+    // Per-run scratch: model input and output live in the arena, names and shapes are cached
+    ScratchArena arena_;
+    std::string input_name_;
+    std::string output_name_;
+    size_t output_frames_;    // Output shape learned from the first run (0 = not yet known)
+    size_t output_classes_;
+    std::vector<const float*> batch_windows_;
+    std::vector<size_t> batch_lengths_;
     
 public:
     explicit SpeakerSegmenter(bool verbose = false);
     ~SpeakerSegmenter();
     
+    /**
+     * Set ONNX Runtime intra-op threads; takes effect at the next initialize()
+     * @param threads Intra-op pool size
+     * @param allow_spinning Let idle pool threads spin (off under a CPU quota)
+     */
+    void set_intra_op_threads(int threads, bool allow_spinning = true);
+    
+    /**
+     * Pin intra-op pool threads 1..N-1 (ORT session.intra_op_thread_affinities format, e.g. "3;4;5");
+     * takes effect at the next initialize()
+     */
+    void set_thread_affinities(const std::string& affinities);
+    
+    /**
+     * Select the execution provider (cpu, xnnpack or dnnl); takes effect at the next initialize()
+     */
+    void set_provider(const std::string& provider) { provider_ = provider; }
+    
+    /**
+     * Provider the loaded model runs on: "cpu", "<provider>" or "<provider>+cpu" (per-node fallback)
+     */
+    const std::string& get_provider() const { return provider_used_; }
+    
     /**
      * Initialize the segmenter with an ONNX model
      * @param model_path Path to the segmentation ONNX model
      * @param sample_rate Audio sample rate (default: 16000)
+     * @param window_duration Window length in seconds (default: 3.2)
+     * @param hop_duration Hop between windows in seconds (default: 1.6, 50% overlap)
      * @return true if initialization successful
      */
-    bool initialize(const std::string& model_path, int sample_rate = 16000);
+    bool initialize(const std::string& model_path, int sample_rate = 16000,
+                    float window_duration = 3.2f, float hop_duration = 1.6f);
     
     /**
      * Detect speaker change points in audio
-     * @param audio Input audio samples (normalized float)
+     * @param audio Input audio samples
      * @param threshold Minimum probability for speaker change detection
-     * @return Vector of timestamps (in seconds) where speaker changes occur
+     * @return Vector of sample indices where speaker changes occur
      */
-    std::vector<float> detect_change_points(const std::vector<float>& audio, float threshold = 0.5f);
+    std::vector<int64_t> detect_change_points(const AudioBuffer& audio, float threshold = 0.5f);
     
     /**
      * Process a single audio window and return change probabilities
@@ -50,22 +103,110 @@ public:
      */
     std::vector<float> process_window(const std::vector<float>& audio_window);
     
+    /**
+     * Process a single audio window and decode per-speaker activity
+     * @param audio_window Audio samples for this window (zero-padded if short)
+     * @param start_sample Position of the window on the audio timeline
+     * @return Local speaker activity, including overlapping speech (empty on failure)
+     */
+    WindowActivity process_window_activity(const std::vector<float>& audio_window, int64_t start_sample);
+    
+    /**
+     * Process several windows in batched model runs and decode per-speaker activity
+     * @param audio_windows Audio samples per window (zero-padded if short)
+     * @param start_samples Position of each window on the audio timeline
+     * @param batch_size Windows per model run (clamped to what the model accepts)
+     * @return Local speaker activity per window (empty entries on failure)
+     */
+    std::vector<WindowActivity> process_windows_activity(const std::vector<std::vector<float>>& audio_windows,
+                                                         const std::vector<int64_t>& start_samples,
+                                                         size_t batch_size);
+    
+    /**
+     * Same, reading the windows straight out of the recording instead of from copies
+     * @param audio Whole recording (int16); window i starts at start_samples[i] and is zero-padded past the end
+     * @param gain Block peaks of audio, so window gains need no rescan
+     * @param results Reused across calls: entries keep their buffers, so steady-state calls do not allocate
+     */
+    void process_windows_activity(const AudioBuffer& audio,
+                                  const AudioGain& gain,
+                                  const std::vector<int64_t>& start_samples,
+                                  size_t batch_size,
+                                  std::vector<WindowActivity>& results);
+    
+    /**
+     * Window size in samples
+     */
+    int get_window_size() const { return window_size_; }
+    
+    /**
+     * Hop size in samples
+     */
+    int get_hop_size() const { return hop_size_; }
+    
+    /**
+     * Largest number of windows per model run
+     */
+    size_t get_max_batch_size() const { return max_batch_size_; }
+    
     /**
      * Check if the segmenter is properly initialized
      */
     bool is_initialized() const { return session_ != nullptr; }
     
+    /**
+     * Abort the running inference and refuse new ones (safe to call from another thread)
+     */
+    void terminate();
+    
+    /**
+     * Allow inference again after terminate()
+     */
+    void clear_terminate();
+    
 private:
     /**
-     * Normalize audio window to [-1, 1] range
+     * Run the model on one window and copy out the raw frame logits
+     * @return false if the output has an unexpected shape
+     */
+    bool run_model(const std::vector<float>& audio_window,
+                   std::vector<float>& logits,
+                   size_t& time_steps,
+                   size_t& num_classes);
+    
+    /**
+     * Run the model on a batch of windows, copied, zero-padded and normalized into the arena
+     * input in one pass; the output is written into the arena too once its shape is known
+     * @return Logits of window b at b * time_steps * num_classes, valid until the next run (nullptr on failure)
+     */
+    const float* run_batch(const float* const* windows,
+                           const size_t* lengths,
+                           size_t count,
+                           size_t& time_steps,
+                           size_t& num_classes);
+    
+    /**
+     * Same, converting windows of the int16 recording that start at start_samples[0..count);
+     * gains come from the block peaks instead of a scan
+     */
+    const float* run_batch(const AudioBuffer& audio,
+                           const AudioGain& gain,
+                           const int64_t* start_samples,
+                           size_t count,
+                           size_t& time_steps,
+                           size_t& num_classes);
+    
+    /**
+     * Run the model on a filled arena input of count windows
      */
-    void normalize_audio(std::vector<float>& audio);
+    const float* run_input(float* batch_input,
+                           size_t count,
+                           size_t& time_steps,
+                           size_t& num_classes);
     
     /**
-     * Find peaks in probability signal that indicate speaker changes
+     * Decode batched logits into the activity of windows first..first + count
      */
-    std::vector<float> find_peaks(const std::vector<float>& probabilities, 
-                                  float threshold, 
-                                  size_t window_start_sample,
-                                  int samples_per_frame);
+    bool decode_batch(const float* logits, size_t time_steps, size_t num_classes,
+                      WindowActivity* results, size_t count);
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+// src/native/diarization/include/speaker-tracker.h
+#pragma once
+
+#include "powerset-decoder.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * A local speaker followed across consecutive overlapping windows
+ * Activity is stored on the global frame grid starting at first_frame
+ */
+struct SpeakerTrack {
+    int id = -1;
+    int64_t first_frame = 0;             // Global frame index of activity_sum[0]
+    std::vector<float> activity_sum;     // Accumulated activity per frame
+    std::vector<uint16_t> coverage;      // Number of windows contributing per frame
+    size_t window_count = 0;             // Windows linked into this track
+    std::vector<int> conflicts;          // Tracks present in a same window, hence other speakers
+
+    int64_t end_frame() const { return first_frame + static_cast<int64_t>(activity_sum.size()); }
+
+    /**
+     * Mean activity at a global frame (0 outside the track)
+     */
+    float activity(int64_t frame) const {
+        if (frame < first_frame || frame >= end_frame()) return 0.0f;
+        size_t i = static_cast<size_t>(frame - first_frame);
+        return coverage[i] ? activity_sum[i] / coverage[i] : 0.0f;
+    }
+};
+
+/**
+ * SpeakerTracker links local speakers of overlapping segmentation windows
+ * Local speakers of consecutive windows are matched by the permutation that maximizes
+ * the correlation of their activity on the overlap region. Linked local speakers form
+ * a track, so the embedding model only has to run once per track instead of per segment.
+ */
+class SpeakerTracker {
+private:
+    int64_t window_size_;         // Window length in samples
+    float link_threshold_;        // Minimum overlap correlation to link two local speakers
+    float activity_threshold_;    // Minimum peak activity for a local speaker to be present
+    bool verbose_;
+
+    size_t frames_per_window_;    // Taken from the first window
+    std::vector<SpeakerTrack> tracks_;
+
+    // Previously added window and the track each of its local speakers belongs to
+    bool has_previous_;
+    int64_t previous_offset_;
+    WindowActivity previous_;
+    std::vector<int> previous_track_ids_;
+    size_t link_count_;
+
+    // Per-window scratch, kept so steady-state linking does not allocate
+    std::vector<bool> present_;
+    std::vector<int> track_ids_;
+    std::vector<float> scores_;
+    std::vector<size_t> perm_;
+    std::vector<size_t> best_perm_;
+
+public:
+    explicit SpeakerTracker(int64_t window_size,
+                            float link_threshold = 0.5f,
+                            float activity_threshold = 0.5f,
+                            bool verbose = false);
+
+    /**
+     * Add the next window; windows must be added in increasing start order
+     * @param window Decoded local speaker activity
+     */
+    void add_window(const WindowActivity& window);
+
+    /**
+     * Tracks built so far
+     */
+    const std::vector<SpeakerTrack>& tracks() const { return tracks_; }
+
+    /**
+     * Number of local speaker links made across window boundaries
+     */
+    size_t link_count() const { return link_count_; }
+
+    /**
+     * Frames per window (0 until the first window is added)
+     */
+    size_t frames_per_window() const { return frames_per_window_; }
+
+    /**
+     * Convert a global frame index to the first sample it covers
+     */
+    int64_t frame_to_sample(int64_t frame) const;
+
+    /**
+     * Convert a sample index to the nearest global frame index
+     */
+    int64_t sample_to_frame(int64_t sample) const;
+
+    /**
+     * Drop all tracks and linking state
+     */
+    void reset();
+
+private:
+    /**
+     * Correlation of two local speakers' activity on the overlap of two windows
+     */
+    float overlap_correlation(const WindowActivity& prev, size_t prev_speaker,
+                              const WindowActivity& cur, size_t cur_speaker,
+                              int64_t overlap_start, int64_t overlap_end,
+                              int64_t prev_offset, int64_t cur_offset) const;
+
+    /**
+     * Accumulate one local speaker column of a window into a track
+     */
+    void accumulate(SpeakerTrack& track, const WindowActivity& window, size_t speaker, int64_t offset);
+};
@@ -0,0 +1,85 @@
+// src/native/diarization/include/spool-worker.h
+#pragma once
+
+#include "diarize-cli.h"
+#include <string>
+#include <vector>
+#include <atomic>
+
+/**
+ * SpoolWorker processes recordings dropped into a shared spool directory
+ * Any number of workers, on one or several hosts, may serve the same spool:
+ *
+ *   <spool>/incoming/   recordings to diarize (write elsewhere, then rename in)
+ *   <spool>/leased/     claimed jobs: <name>@<worker>@<claim time>, mtime is the heartbeat
+ *   <spool>/done/       <name> (input), <name>.json (result), <name>.done (marker, written last)
+ *   <spool>/failed/     <name> and <name>.error
+ *
+ * A job is claimed by renaming it from incoming/ to leased/, which exactly one worker can
+ * win. The owner touches its lease while working; a lease whose heartbeat is older than the
+ * lease time is renamed back to incoming/ by any worker. Models stay loaded across jobs.
+ */
+class SpoolWorker {
+private:
+    DiarizationEngine& engine_;
+    DiarizeOptions options_;       // Per-job options; audio and output paths are set per job
+    std::string spool_dir_;
+    std::string worker_id_;
+    double lease_seconds_;
+    bool verbose_;
+    size_t jobs_done_;
+    size_t jobs_failed_;
+    int inotify_fd_;               // -1 when polling
+
+public:
+    SpoolWorker(DiarizationEngine& engine, const DiarizeOptions& options);
+    
+    /**
+     * Serve the spool until stop() is requested
+     * @return Process exit code
+     */
+    int run();
+    
+    /**
+     * Ask all workers of this process to exit after their current job (async-signal-safe)
+     */
+    static void stop() { stop_requested_ = true; }
+    
+    /**
+     * Default worker ID: host name and process ID
+     */
+    static std::string default_worker_id();
+
+private:
+    static std::atomic<bool> stop_requested_;
+    
+    /**
+     * Create the spool subdirectories
+     */
+    bool prepare_directories();
+    
+    /**
+     * Claim the next incoming job
+     * @param name Set to the job name
+     * @param lease_path Set to the path of the lease file
+     * @return true if a job was claimed
+     */
+    bool claim_job(std::string& name, std::string& lease_path);
+    
+    /**
+     * Diarize a claimed job and publish its result
+     */
+    void process_job(const std::string& name, const std::string& lease_path);
+    
+    /**
+     * Return expired leases of crashed or stalled workers to incoming/
+     */
+    void recover_stale_leases();
+    
+    /**
+     * Block until incoming/ may have changed or the timeout expires (inotify on Linux, polling elsewhere)
+     */
+    void wait_for_jobs(int timeout_ms);
+    
+    std::string dir(const char* name) const { return spool_dir_ + "/" + name; }
+};
@@ -0,0 +1,131 @@
+// src/native/diarization/include/stage-profiler.h
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <ostream>
+#include <cstdint>
+#include "allocation-counter.h"
+
+/**
+ * Wall time and heap allocations of one pipeline stage
+ */
+struct ProfileStage {
+    std::string name;
+    double seconds = 0.0;
+    size_t count = 0;     // Times the stage was entered
+    uint64_t allocations = 0;          // Heap allocations made by the pipeline
+    uint64_t bytes = 0;                // Bytes requested by those allocations
+    uint64_t runtime_allocations = 0;  // Heap allocations made inside ONNX Runtime inference
+};
+
+/**
+ * Heap allocations of one steady-state unit of work inside a stage (a window batch, an
+ * embedding batch, a cluster update). The first call sizes scratch buffers and is left out
+ * of the peaks, so a peak above zero is an allocation on every call, not a one-time cost.
+ */
+struct ProfileUnit {
+    std::string name;
+    size_t count = 0;
+    uint64_t allocations = 0;       // All calls
+    uint64_t bytes = 0;
+    uint64_t peak_allocations = 0;  // Most allocations of one call after the first
+    uint64_t peak_bytes = 0;
+};
+
+/**
+ * StageProfiler accumulates wall time and allocation counts per pipeline stage for --profile
+ * Stages run one after the other, so entering a stage ends the previous one. One-time costs
+ * (model_load, warmup) are kept apart from per-job stages (audio_load, segmentation, ...).
+ * Units are tagged with a ProfileScope inside the running stage.
+ */
+class StageProfiler {
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    std::vector<ProfileStage> stages_;  // In order of first entry
+    int current_;                       // Index of the running stage, -1 = none
+    Clock::time_point started_;
+    AllocationCounter::Snapshot allocations_;  // Counters when the running stage began
+    
+    std::vector<ProfileUnit> units_;    // In order of first entry
+    int current_unit_;                  // Index of the running unit, -1 = none
+    AllocationCounter::Snapshot unit_allocations_;
+
+public:
+    StageProfiler();
+    
+    /**
+     * End the running stage, if any, and start timing this one
+     */
+    void begin(const std::string& stage);
+    
+    /**
+     * End the running stage
+     */
+    void end();
+    
+    /**
+     * Drop all stages and units, ending the running ones
+     */
+    void reset();
+    
+    /**
+     * Start counting one call of a steady-state unit; units do not nest
+     */
+    void begin_unit(const char* unit);
+    
+    /**
+     * End the running unit
+     */
+    void end_unit();
+    
+    /**
+     * Accumulated stages, in order of first entry
+     */
+    const std::vector<ProfileStage>& stages() const { return stages_; }
+    
+    /**
+     * Accumulated units, in order of first entry
+     */
+    const std::vector<ProfileUnit>& units() const { return units_; }
+    
+    /**
+     * Print a table of stage times, shares and allocation counts, then the units
+     */
+    void print(std::ostream& out) const;
+    
+    /**
+     * Parse an allocation budget list ("window_batch=8,embedding_batch=2")
+     * @return false if an entry is not unit=count
+     */
+    static bool parse_budgets(const std::string& list, std::vector<std::pair<std::string, uint64_t>>& budgets);
+    
+    /**
+     * Compare each budgeted unit's peak allocations per call with its budget
+     * @param budgets Budget list in parse_budgets() format
+     * @param out Receives one line per unit over budget
+     * @return true if every budgeted unit that ran stayed within its budget
+     */
+    bool check_budgets(const std::string& budgets, std::ostream& out) const;
+};
+
+/**
+ * Counts one call of a unit for as long as it lives; does nothing without a profiler
+ */
+class ProfileScope {
+private:
+    StageProfiler* profiler_;
+
+public:
+    ProfileScope(StageProfiler* profiler, const char* unit) : profiler_(profiler) {
+        if (profiler_) profiler_->begin_unit(unit);
+    }
+    ~ProfileScope() {
+        if (profiler_) profiler_->end_unit();
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <cstdint>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -25,6 +26,8 @@ static inline std::wstring string_to_wstring(const std::string& str) {
 // Forward declarations
 struct AudioSegment;
 struct DiarizeOptions;
+struct DiarizeStats;
+class AudioBuffer;
 
 namespace Utils {
 
@@ -40,6 +43,18 @@ namespace Audio {
      */
     std::vector<float> load_audio_file(const std::string& file_path, int target_sample_rate = 16000);
     
+    /**
+     * Load audio file as 16-bit samples, half the memory of load_audio_file
+     * Mono files at the target rate are read as int16 directly and raw PCM files are mapped;
+     * anything else is decoded, mixed and resampled as float, then quantized. Sources with more
+     * than 16 bits, and mixed or resampled audio, lose precision below 16 bits (noise near
+     * -96 dBFS) compared with load_audio_file.
+     * @param file_path Path to audio file
+     * @param target_sample_rate Desired sample rate (will resample if needed)
+     * @return Audio buffer (include audio-buffer.h)
+     */
+    AudioBuffer load_audio_buffer(const std::string& file_path, int target_sample_rate = 16000);
+    
     /**
      * Simple audio loading for raw PCM files
      * @param file_path Path to raw PCM file
@@ -73,15 +88,19 @@ namespace Json {
      * Output diarization results as JSON
      * @param segments Diarization segments
      * @param options Diarization options used
+     * @param stats Work counters of the run
      */
-    void output_results(const std::vector<AudioSegment>& segments, const DiarizeOptions& options);
+    void output_results(const std::vector<AudioSegment>& segments, const DiarizeOptions& options,
+                        const DiarizeStats& stats);
     
     /**
      * Generate speaker statistics
      * @param segments Diarization segments
+     * @param sample_rate Sample rate of the segment timeline
      * @return Map of speaker_id -> statistics
      */
-    std::map<int, std::map<std::string, float>> generate_speaker_stats(const std::vector<AudioSegment>& segments);
+    std::map<int, std::map<std::string, float>> generate_speaker_stats(const std::vector<AudioSegment>& segments,
+                                                                       int sample_rate);
 }
 
 /**
@@ -167,12 +186,20 @@ namespace Math {
  * Time formatting utilities
  */
 namespace Time {
+    /**
+     * Convert a sample index on the audio timeline to seconds
+     * @param sample Sample index (or sample count)
+     * @param sample_rate Sample rate of the timeline
+     * @return Time in seconds
+     */
+    double samples_to_seconds(int64_t sample, int sample_rate);
+    
     /**
      * Format seconds as HH:MM:SS.mmm
      * @param seconds Time in seconds
      * @return Formatted time string
      */
-    std::string format_time(float seconds);
+    std::string format_time(double seconds);
     
     /**
      * Get current timestamp as ISO string
@@ -0,0 +1,68 @@
+#!/bin/bash
+# Check steady-state allocations per call against budgets, for each --preset.
+# Fails when a window batch, embedding batch or cluster update allocates more than its budget
+# in any call after the first (the first sizes scratch buffers). Build with
+# -DDIARIZATION_ALLOCATION_TRACKING=ON so malloc from C code and libraries is counted too.
+# Runs without --state or --checkpoint, whose writes are not steady-state work.
+#
+# Usage: scripts/benchmark-allocations.sh <audio> <segment-model> <embedding-model> [extra options]
+
+set -e
+
+if [ "$#" -lt 3 ]; then
+    echo "Usage: $0 <audio> <segment-model> <embedding-model> [extra options]"
+    exit 1
+fi
+
+AUDIO="$1"
+SEGMENT_MODEL="$2"
+EMBEDDING_MODEL="$3"
+shift 3
+
+DIARIZE_CLI="${DIARIZE_CLI:-./build/diarize-cli}"
+PRESETS="${PRESETS:-fast balanced accurate}"
+BUDGETS="${ALLOCATION_BUDGETS:-window_batch=8,embedding_batch=2,cluster_update=4}"
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+echo "Budgets: $BUDGETS"
+echo "| Preset | Unit | Calls | Mean allocs | Peak allocs | Peak bytes | Result |"
+echo "|--------|------|-------|-------------|-------------|------------|--------|"
+
+failed=0
+for preset in $PRESETS; do
+    status=0
+    "$DIARIZE_CLI" --audio "$AUDIO" \
+                   --segment-model "$SEGMENT_MODEL" \
+                   --embedding-model "$EMBEDDING_MODEL" \
+                   --preset "$preset" \
+                   --warmup --allocation-budget "$BUDGETS" \
+                   --no-autotune-cache \
+                   --output "$WORK_DIR/$preset.json" "$@" > /dev/null 2> "$WORK_DIR/$preset.log" || status=$?
+    
+    if [ ! -f "$WORK_DIR/$preset.json" ]; then
+        echo "| $preset | - | - | - | - | - | run failed |"
+        cat "$WORK_DIR/$preset.log" >&2
+        failed=1
+        continue
+    fi
+    
+    python3 - "$WORK_DIR/$preset.json" "$preset" "$BUDGETS" <<'PY'
+import json, sys
+units = json.load(open(sys.argv[1]))["processing"].get("profile_units", {})
+budgets = dict((name, int(count)) for name, count in (entry.split("=") for entry in sys.argv[3].split(",")))
+for name, unit in units.items():
+    budget = budgets.get(name)
+    result = "-" if budget is None else ("ok" if unit["peak_allocations"] <= budget else "over budget")
+    mean = unit["allocations"] / unit["calls"] if unit["calls"] else 0
+    print("| %s | %s | %d | %.1f | %d | %d | %s |" % (sys.argv[2], name, unit["calls"], mean,
+                                                  unit["peak_allocations"], unit["peak_bytes"], result))
+PY
+    
+    if [ "$status" -ne 0 ]; then
+        grep "❌" "$WORK_DIR/$preset.log" >&2 || true
+        failed=1
+    fi
+done
+
+exit $failed
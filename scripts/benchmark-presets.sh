@@ -0,0 +1,115 @@
+#!/bin/bash
+# Measure real-time factor and diarization error rate of each --preset on a reference corpus.
+# The corpus is a directory of <name>.wav recordings with <name>.rttm references. DER is
+# frame-based (10 ms, no collar, overlap counted) with the optimal speaker mapping.
+#
+# Usage: scripts/benchmark-presets.sh <corpus-dir> <segment-model> <embedding-model> [extra options]
+
+set -e
+
+if [ "$#" -lt 3 ]; then
+    echo "Usage: $0 <corpus-dir> <segment-model> <embedding-model> [extra options]"
+    exit 1
+fi
+
+CORPUS="$1"
+SEGMENT_MODEL="$2"
+EMBEDDING_MODEL="$3"
+shift 3
+
+DIARIZE_CLI="${DIARIZE_CLI:-./build/diarize-cli}"
+PRESETS="${PRESETS:-fast balanced accurate}"
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+echo "| Preset | Files | Audio (s) | Processing (s) | RTF | DER |"
+echo "|--------|-------|-----------|----------------|-----|-----|"
+
+for preset in $PRESETS; do
+    mkdir -p "$WORK_DIR/$preset"
+    processing=0
+    
+    for audio in "$CORPUS"/*.wav; do
+        name="$(basename "$audio" .wav)"
+        [ -f "$CORPUS/$name.rttm" ] || continue
+        
+        started=$(date +%s.%N)
+        "$DIARIZE_CLI" --audio "$audio" \
+                       --segment-model "$SEGMENT_MODEL" \
+                       --embedding-model "$EMBEDDING_MODEL" \
+                       --preset "$preset" \
+                       --output "$WORK_DIR/$preset/$name.json" "$@" > /dev/null
+        finished=$(date +%s.%N)
+        processing=$(echo "$processing + $finished - $started" | bc -l)
+    done
+    
+    python3 - "$CORPUS" "$WORK_DIR/$preset" "$preset" "$processing" <<'PYTHON'
+import glob, itertools, json, os, sys, wave
+
+corpus, results, preset, processing = sys.argv[1], sys.argv[2], sys.argv[3], float(sys.argv[4])
+STEP = 0.01
+
+def frames(turns, length):
+    grid = [set() for _ in range(length)]
+    for start, end, speaker in turns:
+        for f in range(int(start / STEP), min(length, int(end / STEP))):
+            grid[f].add(speaker)
+    return grid
+
+def best_mapping(ref, hyp):
+    ref_speakers = sorted({s for f in ref for s in f})
+    hyp_speakers = sorted({s for f in hyp for s in f})
+    overlap = {(r, h): 0 for r in ref_speakers for h in hyp_speakers}
+    for r_set, h_set in zip(ref, hyp):
+        for r in r_set:
+            for h in h_set:
+                overlap[(r, h)] += 1
+    try:
+        from scipy.optimize import linear_sum_assignment
+        cost = [[-overlap[(r, h)] for h in hyp_speakers] for r in ref_speakers]
+        rows, cols = linear_sum_assignment(cost) if cost and cost[0] else ([], [])
+        return {hyp_speakers[c]: ref_speakers[r] for r, c in zip(rows, cols)}
+    except ImportError:
+        # Exhaustive search; fine for the handful of speakers in a meeting
+        best, best_score = {}, -1
+        short, long_ = (hyp_speakers, ref_speakers) if len(hyp_speakers) <= len(ref_speakers) else (ref_speakers, hyp_speakers)
+        for perm in itertools.permutations(long_, len(short)):
+            pairs = list(zip(short, perm)) if short is hyp_speakers else [(h, r) for r, h in zip(short, perm)]
+            score = sum(overlap[(r, h)] for h, r in pairs)
+            if score > best_score:
+                best, best_score = dict(pairs), score
+        return best
+
+audio_seconds = error = total = 0.0
+files = 0
+for rttm in sorted(glob.glob(os.path.join(corpus, "*.rttm"))):
+    name = os.path.splitext(os.path.basename(rttm))[0]
+    result = os.path.join(results, name + ".json")
+    if not os.path.exists(result):
+        continue
+    with wave.open(os.path.join(corpus, name + ".wav")) as w:
+        duration = w.getnframes() / w.getframerate()
+    length = int(duration / STEP) + 1
+    
+    ref_turns = []
+    for line in open(rttm):
+        fields = line.split()
+        if len(fields) >= 8 and fields[0] == "SPEAKER":
+            start, dur = float(fields[3]), float(fields[4])
+            ref_turns.append((start, start + dur, fields[7]))
+    hyp_turns = [(s["start_time"], s["end_time"], s["speaker_id"]) for s in json.load(open(result))["segments"]]
+    
+    ref, hyp = frames(ref_turns, length), frames(hyp_turns, length)
+    mapping = best_mapping(ref, hyp)
+    for r_set, h_set in zip(ref, hyp):
+        mapped = {mapping.get(h) for h in h_set}
+        error += max(len(r_set), len(h_set)) - len(r_set & mapped)
+        total += len(r_set)
+    audio_seconds += duration
+    files += 1
+
+rtf = processing / audio_seconds if audio_seconds else 0.0
+der = 100.0 * error / total if total else 0.0
+print(f"| {preset} | {files} | {audio_seconds:.1f} | {processing:.1f} | {rtf:.3f} | {der:.1f}% |")
+PYTHON
+done
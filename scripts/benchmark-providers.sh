@@ -0,0 +1,52 @@
+#!/bin/bash
+# Compare CPU execution providers per model on this machine.
+# Each provider is tried on one model at a time while the other model stays on cpu, so the
+# difference to the cpu row is that model's gain. Providers missing from the ONNX Runtime
+# build show up with placement "cpu".
+#
+# Usage: scripts/benchmark-providers.sh <audio> <segment-model> <embedding-model> [extra options]
+
+set -e
+
+if [ "$#" -lt 3 ]; then
+    echo "Usage: $0 <audio> <segment-model> <embedding-model> [extra options]"
+    exit 1
+fi
+
+AUDIO="$1"
+SEGMENT_MODEL="$2"
+EMBEDDING_MODEL="$3"
+shift 3
+
+DIARIZE_CLI="${DIARIZE_CLI:-./build/diarize-cli}"
+PROVIDERS="${PROVIDERS:-cpu xnnpack dnnl}"
+RUNS="${RUNS:-3}"
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+echo "| Model | Provider | Placement | Processing (s) |"
+echo "|-------|----------|-----------|----------------|"
+
+for model in segmentation embedding; do
+    for provider in $PROVIDERS; do
+        best=""
+        for run in $(seq "$RUNS"); do
+            started=$(date +%s.%N)
+            "$DIARIZE_CLI" --audio "$AUDIO" \
+                           --segment-model "$SEGMENT_MODEL" \
+                           --embedding-model "$EMBEDDING_MODEL" \
+                           --provider cpu --"$model"-provider "$provider" \
+                           --no-autotune-cache \
+                           --output "$WORK_DIR/result.json" "$@" > /dev/null
+            finished=$(date +%s.%N)
+            elapsed=$(echo "$finished - $started" | bc -l)
+            if [ -z "$best" ] || [ "$(echo "$elapsed < $best" | bc -l)" = 1 ]; then
+                best=$elapsed
+            fi
+        done
+
+        placement=$(python3 -c "import json, sys; print(json.load(open(sys.argv[1]))['model_info']['providers'][sys.argv[2]])" \
+                    "$WORK_DIR/result.json" "$model")
+        printf "| %s | %s | %s | %.2f |\n" "$model" "$provider" "$placement" "$best"
+    done
+done
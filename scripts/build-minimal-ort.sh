@@ -0,0 +1,58 @@
+#!/bin/bash
+# Build a minimal ONNX Runtime reduced to the operators of the bundled models.
+# 1. Converts models/*.onnx to ORT format (*.ort, pre-optimized) next to the originals; the
+#    converter also writes required_operators.config listing every operator and type they use.
+# 2. Builds ONNX Runtime from source with --minimal_build and that config, so only those
+#    kernels are compiled in, and installs it to temp/onnxruntime-minimal.
+# Then configure diarize-cli with -DDIARIZATION_MINIMAL_ORT=ON. A minimal runtime only loads
+# .ort models, so ship the .ort files with the binary.
+#
+# Usage: scripts/build-minimal-ort.sh [models-dir]
+# Needs python3 with the onnxruntime package of the same version, git, cmake and a C++ toolchain.
+
+set -e
+
+ORT_VERSION="${ORT_VERSION:-1.16.3}"
+MODELS_DIR="$(cd "${1:-models}" && pwd)"
+PROJECT_ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+WORK_DIR="$PROJECT_ROOT/temp/onnxruntime-src"
+INSTALL_DIR="$PROJECT_ROOT/temp/onnxruntime-minimal"
+
+echo "🧠 Converting models in $MODELS_DIR to ORT format..."
+# Fixed style bakes in the optimizations the full runtime would apply at load time
+python3 -m onnxruntime.tools.convert_onnx_models_to_ort "$MODELS_DIR" \
+    --optimization_style Fixed \
+    --enable_type_reduction
+OPS_CONFIG="$MODELS_DIR/required_operators_and_types.config"
+if [ ! -f "$OPS_CONFIG" ]; then
+    echo "❌ The converter did not write an operator config"
+    exit 1
+fi
+echo "📄 Operators: $OPS_CONFIG"
+
+if [ ! -d "$WORK_DIR" ]; then
+    git clone --depth 1 --branch "v$ORT_VERSION" --recursive https://github.com/microsoft/onnxruntime.git "$WORK_DIR"
+fi
+
+echo "🔨 Building minimal ONNX Runtime $ORT_VERSION..."
+# Exceptions and RTTI stay enabled: the engine catches Ort::Exception as std::exception
+BUILD_SCRIPT="./build.sh"
+[ "$(uname -s | cut -c1-5)" = "MINGW" ] && BUILD_SCRIPT="./build.bat"
+(cd "$WORK_DIR" && "$BUILD_SCRIPT" \
+    --config MinSizeRel \
+    --build_dir build/minimal \
+    --minimal_build \
+    --include_ops_by_config "$OPS_CONFIG" \
+    --enable_reduced_operator_type_support \
+    --disable_ml_ops \
+    --build_shared_lib \
+    --skip_tests \
+    --parallel)
+
+BUILD_OUT="$WORK_DIR/build/minimal/MinSizeRel"
+mkdir -p "$INSTALL_DIR/lib" "$INSTALL_DIR/include"
+cp -P "$BUILD_OUT"/libonnxruntime.* "$INSTALL_DIR/lib/" 2>/dev/null || cp "$BUILD_OUT"/MinSizeRel/onnxruntime.* "$INSTALL_DIR/lib/"
+cp "$WORK_DIR"/include/onnxruntime/core/session/*.h "$INSTALL_DIR/include/"
+
+echo "✅ Minimal ONNX Runtime installed to $INSTALL_DIR"
+ls -lh "$INSTALL_DIR/lib"
@@ -37,6 +37,10 @@ class CLIBuilder {
       '-DCMAKE_BUILD_TYPE=Release',
       `-DCMAKE_INSTALL_PREFIX=${this.config.binariesDir}`,
       `-DONNXRUNTIME_ROOT=${this.config.nativeDir}`,
+      // Reduced-operator runtime from scripts/build-minimal-ort.sh
+      ...(process.env.DIARIZATION_MINIMAL_ORT === '1' ? ['-DDIARIZATION_MINIMAL_ORT=ON'] : []),
+      // Interposed malloc for scripts/benchmark-allocations.sh
+      ...(process.env.DIARIZATION_ALLOCATION_TRACKING === '1' ? ['-DDIARIZATION_ALLOCATION_TRACKING=ON'] : []),
       this.config.sourceDir
     ];
     
@@ -0,0 +1,41 @@
+#!/bin/bash
+# Sharded diarization on one machine: one process per shard, a temporary directory
+# standing in for the cluster's shared storage, then the merge step.
+#
+# Usage: scripts/shard-local.sh <shards> <audio> <segment-model> <embedding-model> <output.json> [extra options]
+
+set -e
+
+if [ "$#" -lt 5 ]; then
+    echo "Usage: $0 <shards> <audio> <segment-model> <embedding-model> <output.json> [extra options]"
+    exit 1
+fi
+
+SHARDS="$1"
+AUDIO="$2"
+SEGMENT_MODEL="$3"
+EMBEDDING_MODEL="$4"
+OUTPUT="$5"
+shift 5
+
+DIARIZE_CLI="${DIARIZE_CLI:-./build/diarize-cli}"
+SHARD_DIR="$(mktemp -d)"
+trap 'rm -rf "$SHARD_DIR"' EXIT
+
+echo "🧩 Running $SHARDS shards in $SHARD_DIR"
+
+PIDS=()
+for ((i = 0; i < SHARDS; i++)); do
+    "$DIARIZE_CLI" --audio "$AUDIO" \
+                   --segment-model "$SEGMENT_MODEL" \
+                   --embedding-model "$EMBEDDING_MODEL" \
+                   --shard "$i/$SHARDS" --shard-dir "$SHARD_DIR" "$@" &
+    PIDS+=($!)
+done
+
+for pid in "${PIDS[@]}"; do
+    wait "$pid"
+done
+
+"$DIARIZE_CLI" --merge-shards --shard-dir "$SHARD_DIR" --output "$OUTPUT" "$@"
+echo "✅ Merged result written to $OUTPUT"
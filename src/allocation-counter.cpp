@@ -0,0 +1,153 @@
+// src/native/diarization/allocation-counter.cpp
+#include "allocation-counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(DIARIZATION_ALLOCATION_TRACKING) && defined(__GLIBC__)
+#define DIARIZATION_INTERPOSE_MALLOC 1
+#include <cerrno>
+#include <malloc.h>
+
+// glibc's own entry points, so the interposed functions below do not call themselves
+extern "C" {
+    void* __libc_malloc(std::size_t size);
+    void* __libc_calloc(std::size_t count, std::size_t size);
+    void* __libc_realloc(void* memory, std::size_t size);
+    void* __libc_memalign(std::size_t alignment, std::size_t size);
+}
+#endif
+
+namespace {
+
+std::atomic<bool> enabled{false};
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> allocated_bytes{0};
+std::atomic<uint64_t> runtime_allocations{0};
+std::atomic<int> runtime_depth{0};
+
+void count_allocation(std::size_t size) {
+    if (!enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (runtime_depth.load(std::memory_order_relaxed) > 0) {
+        runtime_allocations.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+void* counted_malloc(std::size_t size) {
+#ifndef DIARIZATION_INTERPOSE_MALLOC
+    count_allocation(size);
+#endif
+    // With malloc interposed, the call below is what counts
+    return std::malloc(size ? size : 1);
+}
+
+} // namespace
+
+#ifdef DIARIZATION_INTERPOSE_MALLOC
+// Tracking build: C allocations (ONNX Runtime, jsoncpp, libsndfile, aligned operator new) count too
+extern "C" {
+
+void* malloc(std::size_t size) {
+    count_allocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) {
+    count_allocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* memory, std::size_t size) {
+    // Only a fresh block or growth is an allocation; shrinking or freeing (size 0) is not
+    const std::size_t usable = memory ? malloc_usable_size(memory) : 0;
+    if (!memory || size > usable) {
+        count_allocation(size - usable);
+    }
+    return __libc_realloc(memory, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size) {
+    count_allocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) {
+    count_allocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** memory, std::size_t alignment, std::size_t size) {
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    count_allocation(size);
+    *memory = __libc_memalign(alignment, size);
+    return *memory ? 0 : ENOMEM;
+}
+
+}
+#endif
+
+namespace AllocationCounter {
+
+bool tracking_build() {
+#ifdef DIARIZATION_INTERPOSE_MALLOC
+    return true;
+#else
+    return false;
+#endif
+}
+
+Snapshot snapshot() {
+    Snapshot snapshot;
+    snapshot.allocations = allocations.load(std::memory_order_relaxed);
+    snapshot.bytes = allocated_bytes.load(std::memory_order_relaxed);
+    snapshot.runtime_allocations = runtime_allocations.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void enable() {
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+RuntimeScope::RuntimeScope() : counted_(enabled.load(std::memory_order_relaxed)) {
+    if (counted_) runtime_depth.fetch_add(1, std::memory_order_relaxed);
+}
+
+RuntimeScope::~RuntimeScope() {
+    if (counted_) runtime_depth.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace AllocationCounter
+
+// Replacement global allocation functions (aligned variants keep the library's own pairing;
+// a tracking build counts them through aligned_alloc)
+void* operator new(std::size_t size) {
+    if (void* memory = counted_malloc(size)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* memory = counted_malloc(size)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_malloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_malloc(size);
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
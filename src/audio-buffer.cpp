@@ -0,0 +1,117 @@
+// src/native/diarization/audio-buffer.cpp
+#include "audio-buffer.h"
+#include "simd-kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+struct AudioBuffer::Storage {
+    std::vector<int16_t> samples;  // Owned samples (empty for a mapping)
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    
+    Storage() = default;
+    Storage(const Storage&) = delete;
+    Storage& operator=(const Storage&) = delete;
+    
+    ~Storage() {
+#ifndef _WIN32
+        if (mapping) {
+            munmap(mapping, mapping_size);
+        }
+#endif
+    }
+};
+
+AudioBuffer::AudioBuffer() : samples_(nullptr), size_(0) {
+}
+
+AudioBuffer::AudioBuffer(std::shared_ptr<const Storage> storage, const int16_t* samples, size_t size)
+    : storage_(std::move(storage)), samples_(samples), size_(size) {
+}
+
+AudioBuffer AudioBuffer::from_pcm16(std::vector<int16_t> samples) {
+    auto storage = std::make_shared<Storage>();
+    storage->samples = std::move(samples);
+    const int16_t* data = storage->samples.data();
+    const size_t size = storage->samples.size();
+    return AudioBuffer(std::move(storage), data, size);
+}
+
+AudioBuffer AudioBuffer::from_float(const float* samples, size_t count) {
+    std::vector<int16_t> pcm(count);
+    for (size_t i = 0; i < count; i++) {
+        const float scaled = std::round(samples[i] * 32768.0f);
+        pcm[i] = static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, scaled)));
+    }
+    return from_pcm16(std::move(pcm));
+}
+
+AudioBuffer AudioBuffer::map_pcm16(const std::string& path) {
+#ifndef _WIN32
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open audio file: " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat audio file: " + path);
+    }
+    
+    const size_t size = static_cast<size_t>(info.st_size) / sizeof(int16_t);
+    if (size == 0) {
+        close(fd);
+        return AudioBuffer();
+    }
+    
+    // Read-only and sequential at first; the mapping stays valid after the descriptor is closed
+    void* mapping = mmap(nullptr, size * sizeof(int16_t), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map audio file: " + path);
+    }
+    madvise(mapping, size * sizeof(int16_t), MADV_SEQUENTIAL);
+    
+    auto storage = std::make_shared<Storage>();
+    storage->mapping = mapping;
+    storage->mapping_size = size * sizeof(int16_t);
+    return AudioBuffer(std::move(storage), static_cast<const int16_t*>(mapping), size);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Cannot open audio file: " + path);
+    }
+    std::vector<int16_t> samples(static_cast<size_t>(file.tellg()) / sizeof(int16_t));
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(samples.data()), static_cast<std::streamsize>(samples.size() * sizeof(int16_t)));
+    return from_pcm16(std::move(samples));
+#endif
+}
+
+bool AudioBuffer::mapped() const {
+    return storage_ && storage_->mapping;
+}
+
+size_t AudioBuffer::read(size_t begin, size_t count, float* out, float gain, float emphasis) const {
+    if (begin >= size_) {
+        return 0;
+    }
+    count = std::min(count, size_ - begin);
+    SimdKernels::pcm16_emphasis(out, samples_ + begin, gain * kScale, emphasis, count);
+    return count;
+}
+
+AudioBuffer AudioBuffer::slice(size_t begin, size_t end) const {
+    end = std::min(end, size_);
+    begin = std::min(begin, end);
+    return AudioBuffer(storage_, samples_ + begin, end - begin);
+}
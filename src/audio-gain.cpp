@@ -0,0 +1,42 @@
+// src/native/diarization/audio-gain.cpp
+#include "audio-gain.h"
+#include "simd-kernels.h"
+#include <algorithm>
+
+void AudioGain::analyze(const AudioBuffer& audio) {
+    audio_ = audio;
+    const size_t length = audio.size();
+    
+    block_peaks_.resize((length + kBlockSize - 1) / kBlockSize);
+    for (size_t b = 0; b < block_peaks_.size(); b++) {
+        const size_t begin = b * kBlockSize;
+        block_peaks_[b] = SimdKernels::max_abs_pcm16(audio.data() + begin, std::min(kBlockSize, length - begin));
+    }
+}
+
+float AudioGain::peak(size_t begin, size_t end) const {
+    end = std::min(end, audio_.size());
+    if (begin >= end) {
+        return 0.0f;
+    }
+    
+    // Partial blocks at either end are scanned, whole blocks in between come from the table
+    const size_t first_block = (begin + kBlockSize - 1) / kBlockSize;
+    const size_t last_block = end / kBlockSize;
+    const int16_t* samples = audio_.data();
+    if (first_block >= last_block) {
+        return SimdKernels::max_abs_pcm16(samples + begin, end - begin) * AudioBuffer::kScale;
+    }
+    
+    int32_t max_val = std::max(SimdKernels::max_abs_pcm16(samples + begin, first_block * kBlockSize - begin),
+                               SimdKernels::max_abs_pcm16(samples + last_block * kBlockSize, end - last_block * kBlockSize));
+    for (size_t b = first_block; b < last_block; b++) {
+        max_val = std::max(max_val, block_peaks_[b]);
+    }
+    return max_val * AudioBuffer::kScale;
+}
+
+float AudioGain::gain(size_t begin, size_t end) const {
+    const float max_val = peak(begin, end);
+    return max_val > 1e-6f ? 1.0f / max_val : 1.0f;
+}
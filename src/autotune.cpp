@@ -0,0 +1,310 @@
+// src/native/diarization/autotune.cpp
+#include "autotune.h"
+#include "speaker-segmenter.h"
+#include "speaker-embedder.h"
+#include "execution-provider.h"
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <cmath>
+#include <map>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const std::vector<int> kSegmentationBatches = {1, 2, 4, 8, 16};
+const std::vector<int> kEmbeddingBatches = {1, 4, 8, 16, 32, 64};
+constexpr size_t kProbeItems = 32;   // Windows or segments timed per grid point
+constexpr int kCacheVersion = 1;
+
+// Speech-like probe audio: amplitude-modulated noise, deterministic across runs
+std::vector<float> probe_audio(size_t length) {
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> noise(0.0f, 0.1f);
+    std::vector<float> audio(length);
+    for (size_t n = 0; n < length; n++) {
+        audio[n] = noise(rng) * (0.5f + 0.5f * std::sin(static_cast<float>(n) * 0.0008f));
+    }
+    return audio;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+}
+
+} // namespace
+
+Autotuner::Autotuner(const DiarizeOptions& options, bool verbose)
+    : options_(options), verbose_(verbose) {
+}
+
+std::string Autotuner::host_name() {
+#ifdef _WIN32
+    const char* host = std::getenv("COMPUTERNAME");
+    return host ? host : "localhost";
+#else
+    char host[256] = {0};
+    if (gethostname(host, sizeof(host) - 1) != 0 || !host[0]) {
+        return "localhost";
+    }
+    return host;
+#endif
+}
+
+std::string Autotuner::default_cache_path() {
+    fs::path base;
+#ifdef _WIN32
+    const char* local = std::getenv("LOCALAPPDATA");
+    base = local ? fs::path(local) : fs::temp_directory_path();
+#else
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    base = xdg && *xdg ? fs::path(xdg) : home ? fs::path(home) / ".cache" : fs::temp_directory_path();
+#endif
+    return (base / "whisperdesk-diarization" / ("autotune-" + host_name() + ".conf")).string();
+}
+
+std::string Autotuner::model_key(const std::string& path) {
+    if (path.empty()) return "-";
+    
+    // Path and size of the file actually loaded (.ort or .onnx): cheap, and changes when a
+    // model is replaced by another version or converted
+    std::string file = path;
+    try {
+        file = ExecutionProvider::model_file(path);
+    } catch (const std::exception&) {
+    }
+    std::error_code ec;
+    auto size = fs::file_size(file, ec);
+    return fs::absolute(file, ec).string() + ":" + std::to_string(ec ? 0 : size);
+}
+
+std::vector<int> Autotuner::thread_grid() {
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> grid;
+    for (int threads = 1; threads < cores; threads *= 2) {
+        grid.push_back(threads);
+    }
+    grid.push_back(cores);
+    return grid;
+}
+
+std::vector<double> Autotuner::time_segmentation(int threads, const std::vector<int>& batches) {
+    std::vector<double> times(batches.size(), -1.0);
+    
+    SpeakerSegmenter segmenter(verbose_);
+    segmenter.set_intra_op_threads(threads);
+    segmenter.set_provider(options_.segmentation_provider);
+    if (!segmenter.initialize(options_.segment_model_path, options_.sample_rate,
+                              options_.segment_window, options_.segment_hop)) {
+        return times;
+    }
+    
+    const size_t window_size = static_cast<size_t>(segmenter.get_window_size());
+    const auto audio = probe_audio(window_size);
+    const std::vector<std::vector<float>> windows(kProbeItems, audio);
+    const std::vector<int64_t> starts(kProbeItems, 0);
+    
+    for (size_t i = 0; i < batches.size(); i++) {
+        const size_t batch = static_cast<size_t>(batches[i]);
+        if (batch > segmenter.get_max_batch_size()) continue;
+        
+        // Warm-up run at this shape, then the timed pass
+        segmenter.process_windows_activity({windows.begin(), windows.begin() + batch}, 
+                                           {starts.begin(), starts.begin() + batch}, batch);
+        auto started = std::chrono::steady_clock::now();
+        auto results = segmenter.process_windows_activity(windows, starts, batch);
+        double ms = elapsed_ms(started) / kProbeItems;
+        
+        if (!results.empty() && results.back().num_frames > 0) {
+            times[i] = ms;
+        }
+    }
+    
+    return times;
+}
+
+std::vector<double> Autotuner::time_embedding(int threads, const std::vector<int>& batches) {
+    std::vector<double> times(batches.size(), -1.0);
+    
+    SpeakerEmbedder embedder(verbose_);
+    embedder.set_intra_op_threads(threads);
+    embedder.set_provider(options_.embedding_provider);
+    if (!embedder.initialize(options_.embedding_model_path, options_.sample_rate, options_.embedding_duration)) {
+        return times;
+    }
+    
+    const auto audio = probe_audio(embedder.get_target_length());
+    const std::vector<std::vector<float>> segments(kProbeItems, audio);
+    
+    for (size_t i = 0; i < batches.size(); i++) {
+        const size_t batch = static_cast<size_t>(batches[i]);
+        
+        embedder.extract_embeddings({segments.begin(), segments.begin() + batch}, batch);
+        const size_t runs_before = embedder.get_inference_count();
+        auto started = std::chrono::steady_clock::now();
+        embedder.extract_embeddings(segments, batch);
+        double ms = elapsed_ms(started) / kProbeItems;
+        
+        // A model with a fixed batch dimension silently runs smaller batches: skip duplicates
+        const size_t expected_runs = (kProbeItems + batch - 1) / batch;
+        if (embedder.get_inference_count() - runs_before == expected_runs) {
+            times[i] = ms;
+        }
+    }
+    
+    return times;
+}
+
+bool Autotuner::run(TuneResult& result) {
+    const bool has_segmentation = !options_.segment_model_path.empty();
+    const bool has_embedding = !options_.embedding_model_path.empty();
+    if (!has_segmentation && !has_embedding) {
+        std::cerr << "❌ --autotune needs --segment-model and/or --embedding-model" << std::endl;
+        return false;
+    }
+    
+    double best_total = -1.0;
+    for (int threads : thread_grid()) {
+        std::vector<double> segmentation_times;
+        std::vector<double> embedding_times;
+        if (has_segmentation) segmentation_times = time_segmentation(threads, kSegmentationBatches);
+        if (has_embedding) embedding_times = time_embedding(threads, kEmbeddingBatches);
+        
+        auto best_of = [](const std::vector<double>& times, const std::vector<int>& batches, int& batch, double& ms) {
+            batch = 0;
+            for (size_t i = 0; i < times.size(); i++) {
+                if (times[i] >= 0.0 && (batch == 0 || times[i] < ms)) {
+                    batch = batches[i];
+                    ms = times[i];
+                }
+            }
+            return batch > 0;
+        };
+        
+        TuneResult candidate;
+        candidate.intra_op_threads = threads;
+        bool ok = true;
+        if (has_segmentation) {
+            ok &= best_of(segmentation_times, kSegmentationBatches, candidate.segmentation_batch_size, candidate.segmentation_ms);
+        }
+        if (has_embedding) {
+            ok &= best_of(embedding_times, kEmbeddingBatches, candidate.embedding_batch_size, candidate.embedding_ms);
+        }
+        
+        std::cout << "⚙️ threads " << std::setw(3) << threads << ": " << std::fixed << std::setprecision(2);
+        if (has_segmentation) {
+            std::cout << "segmentation " << candidate.segmentation_ms << " ms/window (batch " 
+                     << candidate.segmentation_batch_size << ")  ";
+        }
+        if (has_embedding) {
+            std::cout << "embedding " << candidate.embedding_ms << " ms/segment (batch " 
+                     << candidate.embedding_batch_size << ")";
+        }
+        std::cout << (ok ? "" : "  (failed)") << std::endl;
+        
+        const double total = candidate.segmentation_ms + candidate.embedding_ms;
+        if (ok && (best_total < 0.0 || total < best_total)) {
+            best_total = total;
+            result = candidate;
+        }
+    }
+    
+    if (best_total < 0.0) {
+        std::cerr << "❌ Autotune failed: no setting could run the models" << std::endl;
+        return false;
+    }
+    
+    // A model that was not tuned keeps the current setting
+    if (!has_segmentation) result.segmentation_batch_size = options_.segmentation_batch_size;
+    if (!has_embedding) result.embedding_batch_size = options_.embedding_batch_size;
+    return true;
+}
+
+bool Autotuner::save(const std::string& path, const DiarizeOptions& options, const TuneResult& result) {
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    
+    // Write-then-rename: concurrent runs never read a half-written cache
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path);
+        if (!file) {
+            std::cerr << "❌ Cannot write autotune cache: " << path << std::endl;
+            return false;
+        }
+        file << "version=" << kCacheVersion << "\n"
+             << "host=" << host_name() << "\n"
+             << "cpus=" << std::thread::hardware_concurrency() << "\n"
+             << "segment_model=" << model_key(options.segment_model_path) << "\n"
+             << "embedding_model=" << model_key(options.embedding_model_path) << "\n"
+             << "providers=" << options.segmentation_provider << "," << options.embedding_provider << "\n"
+             << "embedding_duration=" << std::to_string(options.embedding_duration) << "\n"
+             << "intra_op_threads=" << result.intra_op_threads << "\n"
+             << "segmentation_batch=" << result.segmentation_batch_size << "\n"
+             << "embedding_batch=" << result.embedding_batch_size << "\n"
+             << "segmentation_ms=" << result.segmentation_ms << "\n"
+             << "embedding_ms=" << result.embedding_ms << "\n";
+    }
+    
+    fs::rename(temp_path, path, ec);
+    if (ec) {
+        std::cerr << "❌ Cannot write autotune cache: " << path << " (" << ec.message() << ")" << std::endl;
+        fs::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+bool Autotuner::load(const std::string& path, const DiarizeOptions& options, TuneResult& result) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    
+    std::map<std::string, std::string> values;
+    std::string line;
+    while (std::getline(file, line)) {
+        auto eq = line.find('=');
+        if (eq != std::string::npos) {
+            values[line.substr(0, eq)] = line.substr(eq + 1);
+        }
+    }
+    
+    // Settings from another host, CPU allotment, model version, provider or embedding input
+    // length would be misleading
+    if (values["version"] != std::to_string(kCacheVersion) ||
+        values["host"] != host_name() ||
+        values["cpus"] != std::to_string(std::thread::hardware_concurrency()) ||
+        values["segment_model"] != model_key(options.segment_model_path) ||
+        values["embedding_model"] != model_key(options.embedding_model_path) ||
+        values["providers"] != options.segmentation_provider + "," + options.embedding_provider ||
+        values["embedding_duration"] != std::to_string(options.embedding_duration)) {
+        return false;
+    }
+    
+    try {
+        result.intra_op_threads = std::stoi(values["intra_op_threads"]);
+        result.segmentation_batch_size = std::stoi(values["segmentation_batch"]);
+        result.embedding_batch_size = std::stoi(values["embedding_batch"]);
+        result.segmentation_ms = std::stod(values["segmentation_ms"]);
+        result.embedding_ms = std::stod(values["embedding_ms"]);
+    } catch (const std::exception&) {
+        return false;
+    }
+    
+    return result.intra_op_threads > 0 && result.segmentation_batch_size > 0 && result.embedding_batch_size > 0;
+}
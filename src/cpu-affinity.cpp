@@ -0,0 +1,112 @@
+// src/native/diarization/cpu-affinity.cpp
+#include "cpu-affinity.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
+
+#ifdef __linux__
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace CpuAffinity {
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cores;
+    std::stringstream stream(list);
+    std::string range;
+    
+    while (std::getline(stream, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+        if (range.empty()) continue;
+        
+        char* end = nullptr;
+        long first = std::strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = std::strtol(end + 1, &end, 10);
+        }
+        if (*end != '\0' || first < 0 || last < first) {
+            return {};
+        }
+        for (long core = first; core <= last; core++) {
+            cores.push_back(static_cast<int>(core));
+        }
+    }
+    
+    return cores;
+}
+
+std::string format_cpu_list(const std::vector<int>& cores) {
+    std::string list;
+    for (size_t i = 0; i < cores.size();) {
+        size_t j = i;
+        while (j + 1 < cores.size() && cores[j + 1] == cores[j] + 1) j++;
+        
+        if (!list.empty()) list += ",";
+        list += std::to_string(cores[i]);
+        if (j > i) list += "-" + std::to_string(cores[j]);
+        i = j + 1;
+    }
+    return list;
+}
+
+std::vector<int> numa_node_cpus(int node) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string line;
+    if (!file || !std::getline(file, line)) {
+        return {};
+    }
+    return parse_cpu_list(line);
+}
+
+std::vector<int> stage_cores(const std::string& list, int numa_node) {
+    if (!list.empty()) {
+        return parse_cpu_list(list);
+    }
+    if (numa_node >= 0) {
+        return numa_node_cpus(numa_node);
+    }
+    return {};
+}
+
+std::string ort_thread_affinities(const std::vector<int>& cores, int threads) {
+    if (cores.empty() || threads < 2) {
+        return "";
+    }
+    
+    std::string affinities;
+    for (int t = 1; t < threads; t++) {
+        if (!affinities.empty()) affinities += ";";
+        affinities += std::to_string(cores[static_cast<size_t>(t) % cores.size()] + 1);
+    }
+    return affinities;
+}
+
+bool pin_current_thread(const std::vector<int>& cores) {
+    if (cores.empty()) {
+        return false;
+    }
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int core : cores) {
+        if (core < CPU_SETSIZE) CPU_SET(core, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;  // 0 = calling thread
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int core : cores) {
+        if (core < static_cast<int>(sizeof(DWORD_PTR) * 8)) mask |= DWORD_PTR(1) << core;
+    }
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+    return false;  // macOS has no hard affinity
+#endif
+}
+
+} // namespace CpuAffinity
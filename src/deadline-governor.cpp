@@ -0,0 +1,88 @@
+// src/native/diarization/deadline-governor.cpp
+#include "deadline-governor.h"
+#include <iostream>
+#include <iomanip>
+
+namespace {
+
+constexpr size_t kProbeUnits = 3;           // Measured units before the first projection
+constexpr double kSegmentationShare = 0.6;  // Budget share of segmentation while embeddings follow
+constexpr double kSafetyMargin = 0.9;       // Plan against this fraction of the remaining time
+constexpr float kLargeHopScale = 1.5f;      // Hop multiplier of the larger-hop step
+constexpr double kMinSilentFraction = 0.05; // Silence skipping is pointless below this
+
+} // namespace
+
+DeadlineGovernor::DeadlineGovernor(double deadline_seconds, bool verbose)
+    : deadline_(deadline_seconds),
+      verbose_(verbose),
+      start_(Clock::now()),
+      skip_silence_(false),
+      hop_scale_(1.0f),
+      fewer_crops_(false),
+      skip_embeddings_(false) {
+}
+
+double DeadlineGovernor::elapsed() const {
+    return std::chrono::duration<double>(Clock::now() - start_).count();
+}
+
+double DeadlineGovernor::remaining() const {
+    return deadline_ - elapsed();
+}
+
+void DeadlineGovernor::apply(const std::string& step, double projected, double budget) {
+    applied_.push_back(step);
+    if (verbose_) {
+        std::cout << "⏱️ Deadline: projected " << std::fixed << std::setprecision(1) << projected 
+                 << "s > budget " << budget << "s, applying " << step << std::endl;
+    }
+}
+
+void DeadlineGovernor::plan_segmentation(size_t windows_done, double seconds, size_t windows_left,
+                                         double silent_fraction, bool embeddings_pending) {
+    if (!active() || windows_done < kProbeUnits || windows_left == 0) {
+        return;
+    }
+    
+    const double per_window = seconds / windows_done;
+    const double available = remaining() * kSafetyMargin;
+    auto budget = [&]() { return available * (embeddings_pending && !skip_embeddings_ ? kSegmentationShare : 1.0); };
+    
+    // Projected cost of the remaining windows under the current settings
+    double projected = per_window * windows_left * (skip_silence_ ? 1.0 - silent_fraction : 1.0);
+    
+    if (projected > budget() && !skip_silence_ && silent_fraction >= kMinSilentFraction) {
+        apply("skip_silence", projected, budget());
+        skip_silence_ = true;
+        projected *= 1.0 - silent_fraction;
+    }
+    if (projected > budget() && hop_scale_ == 1.0f) {
+        apply("larger_hop", projected, budget());
+        hop_scale_ = kLargeHopScale;
+        projected /= kLargeHopScale;
+    }
+    if (projected > budget() && embeddings_pending && !skip_embeddings_) {
+        apply("skip_embeddings", projected, budget());
+        skip_embeddings_ = true;
+    }
+}
+
+void DeadlineGovernor::plan_embedding(size_t tracks_done, double seconds, size_t tracks_left) {
+    if (!active() || skip_embeddings_ || tracks_done < kProbeUnits || tracks_left == 0) {
+        return;
+    }
+    
+    const double budget = remaining() * kSafetyMargin;
+    double projected = seconds / tracks_done * tracks_left;
+    
+    if (projected > budget && !fewer_crops_) {
+        apply("fewer_crops", projected, budget);
+        fewer_crops_ = true;
+        return;  // Re-measure at the cheaper setting before giving up on embeddings
+    }
+    if (projected > budget) {
+        apply("skip_embeddings", projected, budget);
+        skip_embeddings_ = true;
+    }
+}
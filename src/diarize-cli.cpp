@@ -2,6 +2,19 @@
 #include "diarize-cli.h"
 #include "speaker-segmenter.h"
 #include "speaker-embedder.h"
+#include "speaker-tracker.h"
+#include "embedding-cascade.h"
+#include "diarize-state.h"
+#include "shard-merge.h"
+#include "spool-worker.h"
+#include "job-control.h"
+#include "deadline-governor.h"
+#include "autotune.h"
+#include "resource-governor.h"
+#include "cpu-affinity.h"
+#include "simd-kernels.h"
+#include "signal-filters.h"
+#include "audio-buffer.h"
 #include "utils.h"
 
 #include <iostream>
@@ -10,39 +23,255 @@
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <cmath>
+#include <cstdio>
+#include <csignal>
+#include <chrono>
+
+namespace {
+
+// Track pipeline tuning
+constexpr float kActivityThreshold = 0.5f;   // A track is speaking on frames above this activity
+constexpr float kLinkThreshold = 0.5f;       // Minimum overlap correlation to link local speakers
+constexpr size_t kMaxTrackCrops = 3;         // Embedding crops per track at most
+constexpr double kMinSpeechDuration = 0.2;   // Drop speech runs shorter than this (seconds)
+constexpr double kMaxMergeGap = 0.5;         // Bridge same-speaker gaps shorter than this (seconds)
+
+// Uniform-window pipeline tuning
+constexpr float kSilenceRatio = 0.05f;       // Window is silent below this fraction of the loud-window RMS
+constexpr float kEmissionScale = 10.0f;      // Cosine similarity -> HMM log-emission
+constexpr float kSwitchPenalty = 2.0f;       // HMM log-cost of changing speaker between windows
+
+} // namespace
 
 DiarizationEngine::DiarizationEngine(bool verbose) 
-    : verbose_(verbose) {
+    : verbose_(verbose), embedding_run_base_(0), cancelled_(false), progress_(nullptr), profiler_(nullptr) {
     segmenter_ = std::make_unique<SpeakerSegmenter>(verbose);
     embedder_ = std::make_unique<SpeakerEmbedder>(verbose);
+    deadline_ = std::make_unique<DeadlineGovernor>();
 }
 
 DiarizationEngine::~DiarizationEngine() = default;
 
-bool DiarizationEngine::initialize(const std::string& segment_model_path, const std::string& embedding_model_path) {
+bool DiarizationEngine::initialize(const std::string& segment_model_path, 
+                                   const std::string& embedding_model_path,
+                                   const std::string& small_embedding_model_path,
+                                   float cascade_margin) {
+    DiarizeOptions options;
+    options.segment_model_path = segment_model_path;
+    options.embedding_model_path = embedding_model_path;
+    options.small_embedding_model_path = small_embedding_model_path;
+    options.cascade_margin = cascade_margin;
+    return initialize(options);
+}
+
+bool DiarizationEngine::initialize(const DiarizeOptions& options) {
+    const std::string& segment_model_path = options.segment_model_path;
+    const std::string& embedding_model_path = options.embedding_model_path;
+    const std::string& small_embedding_model_path = options.small_embedding_model_path;
+    
     if (verbose_) {
         std::cout << "🔧 Initializing diarization engine..." << std::endl;
     }
     
-    if (!segmenter_->initialize(segment_model_path)) {
+    segmenter_->set_intra_op_threads(options.intra_op_threads, options.thread_spinning);
+    embedder_->set_intra_op_threads(options.intra_op_threads, options.thread_spinning);
+    segmenter_->set_provider(options.segmentation_provider.empty() ? options.provider : options.segmentation_provider);
+    embedder_->set_provider(options.embedding_provider.empty() ? options.provider : options.embedding_provider);
+    
+    // Stage placement: each model's pool is pinned to its stage's cores, and the model is loaded
+    // from a thread on those cores so its weights are first touched on the right NUMA node
+    segmentation_cores_ = CpuAffinity::stage_cores(options.segmentation_cores, options.numa_node);
+    embedding_cores_ = CpuAffinity::stage_cores(options.embedding_cores, options.numa_node);
+    segmenter_->set_thread_affinities(CpuAffinity::ort_thread_affinities(segmentation_cores_, options.intra_op_threads));
+    embedder_->set_thread_affinities(CpuAffinity::ort_thread_affinities(embedding_cores_, options.intra_op_threads));
+    if (verbose_ && (!segmentation_cores_.empty() || !embedding_cores_.empty())) {
+        std::cout << "📌 Cores: segmentation " << CpuAffinity::format_cpu_list(segmentation_cores_) 
+                 << ", embedding " << CpuAffinity::format_cpu_list(embedding_cores_) << std::endl;
+    }
+    
+    // Uniform mode runs without the segmentation model
+    if (profiler_) profiler_->begin("model_load");
+    pin_to_segmentation_cores();
+    if (segment_model_path.empty()) {
+        if (verbose_) {
+            std::cout << "ℹ️ No segmentation model, only uniform mode is available" << std::endl;
+        }
+    } else if (!segmenter_->initialize(segment_model_path, options.sample_rate, 
+                                       options.segment_window, options.segment_hop)) {
         std::cerr << "❌ Failed to initialize speaker segmenter" << std::endl;
         return false;
     }
     
-    if (!embedder_->initialize(embedding_model_path)) {
+    // Fast mode runs without the embedding model
+    pin_to_embedding_cores();
+    if (embedding_model_path.empty()) {
+        if (verbose_) {
+            std::cout << "ℹ️ No embedding model, only fast mode is available" << std::endl;
+        }
+    } else if (!embedder_->initialize(embedding_model_path, options.sample_rate, options.embedding_duration)) {
         std::cerr << "❌ Failed to initialize speaker embedder" << std::endl;
         return false;
     }
     
+    // Optional small model screening every item before the full embedding model
+    if (!small_embedding_model_path.empty() && embedder_->is_initialized()) {
+        small_embedder_ = std::make_unique<SpeakerEmbedder>(verbose_);
+        small_embedder_->set_intra_op_threads(options.intra_op_threads, options.thread_spinning);
+        small_embedder_->set_provider(options.embedding_provider.empty() ? options.provider : options.embedding_provider);
+        small_embedder_->set_thread_affinities(CpuAffinity::ort_thread_affinities(embedding_cores_, options.intra_op_threads));
+        if (!small_embedder_->initialize(small_embedding_model_path, options.sample_rate, options.embedding_duration)) {
+            std::cerr << "❌ Failed to initialize small speaker embedder" << std::endl;
+            return false;
+        }
+        cascade_ = std::make_unique<EmbeddingCascade>(*small_embedder_, *embedder_, options.cascade_margin, verbose_);
+    }
+    
+    if (options.warmup) {
+        if (profiler_) profiler_->begin("warmup");
+        warm_up(options);
+    }
+    if (profiler_) profiler_->end();
+    
     if (verbose_) {
+        std::cout << "🧮 Vector kernels: " << SimdKernels::isa() << std::endl;
         std::cout << "✅ Diarization engine initialized successfully" << std::endl;
     }
     
     return true;
 }
 
-std::vector<AudioSegment> DiarizationEngine::process_audio(const std::vector<float>& audio, const DiarizeOptions& options) {
+std::vector<std::vector<float>> DiarizationEngine::get_speaker_centroids() const {
+    const SpeakerEmbedder& embedder = cascade_ ? *small_embedder_ : *embedder_;
+    
+    std::vector<std::vector<float>> centroids;
+    for (size_t i = 0; i < embedder.get_speaker_count(); i++) {
+        centroids.push_back(embedder.get_speaker_centroid(static_cast<int>(i)));
+    }
+    return centroids;
+}
+
+size_t DiarizationEngine::get_embedding_runs() const {
+    size_t runs = embedder_->get_inference_count();
+    if (small_embedder_) {
+        runs += small_embedder_->get_inference_count();
+    }
+    return runs - embedding_run_base_;
+}
+
+void DiarizationEngine::pin_to_segmentation_cores() {
+    if (!segmentation_cores_.empty() && !CpuAffinity::pin_current_thread(segmentation_cores_) && verbose_) {
+        std::cout << "⚠️ Cannot pin to segmentation cores " << CpuAffinity::format_cpu_list(segmentation_cores_) << std::endl;
+    }
+}
+
+void DiarizationEngine::pin_to_embedding_cores() {
+    if (!embedding_cores_.empty() && !CpuAffinity::pin_current_thread(embedding_cores_) && verbose_) {
+        std::cout << "⚠️ Cannot pin to embedding cores " << CpuAffinity::format_cpu_list(embedding_cores_) << std::endl;
+    }
+}
+
+std::string DiarizationEngine::segmentation_provider() const {
+    return segmenter_->is_initialized() ? segmenter_->get_provider() : "";
+}
+
+std::string DiarizationEngine::embedding_provider() const {
+    return embedder_->is_initialized() ? embedder_->get_provider() : "";
+}
+
+void DiarizationEngine::begin_stage(const std::string& stage) {
+    if (progress_) progress_->begin_stage(stage);
+    if (profiler_) profiler_->begin(stage);
+}
+
+void DiarizationEngine::warm_up(const DiarizeOptions& options) {
+    auto started = std::chrono::steady_clock::now();
+    
+    // Low-level noise rather than zeros, so no kernel takes a shortcut on silence
+    auto noise = [](size_t length) {
+        std::vector<float> audio(length);
+        uint32_t state = 12345;
+        for (auto& sample : audio) {
+            state = state * 1664525u + 1013904223u;
+            sample = (static_cast<float>(state >> 8) / 16777216.0f - 0.5f) * 0.1f;
+        }
+        return audio;
+    };
+    
+    // Full batches and the single-item tail batch
+    if (segmenter_->is_initialized()) {
+        pin_to_segmentation_cores();
+        const size_t batch = std::min(static_cast<size_t>(options.segmentation_batch_size), 
+                                      segmenter_->get_max_batch_size());
+        const std::vector<std::vector<float>> windows(batch, noise(static_cast<size_t>(segmenter_->get_window_size())));
+        const std::vector<int64_t> starts(batch, 0);
+        segmenter_->process_windows_activity(windows, starts, batch);
+        if (batch > 1) {
+            segmenter_->process_windows_activity({windows[0]}, {0}, 1);
+        }
+    }
+    
+    // Track embeddings run all crops of a track at once; uniform mode runs embedding batches
+    pin_to_embedding_cores();
+    const size_t embedding_batch = options.mode == "uniform" ? static_cast<size_t>(options.embedding_batch_size) 
+                                                             : kMaxTrackCrops;
+    for (SpeakerEmbedder* embedder : {embedder_.get(), small_embedder_.get()}) {
+        if (!embedder || !embedder->is_initialized()) continue;
+        const std::vector<std::vector<float>> crops(embedding_batch, noise(embedder->get_target_length()));
+        embedder->extract_embeddings(crops, embedding_batch);
+        if (embedding_batch > 1) {
+            embedder->extract_embeddings({crops[0]}, 1);
+        }
+    }
+    
+    if (verbose_) {
+        std::cout << "🔥 Warm-up took " << std::fixed << std::setprecision(2) 
+                 << std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count() 
+                 << "s" << std::defaultfloat << std::endl;
+    }
+}
+
+void DiarizationEngine::cancel() {
+    cancelled_ = true;
+    segmenter_->terminate();
+    embedder_->terminate();
+    if (small_embedder_) {
+        small_embedder_->terminate();
+    }
+}
+
+void DiarizationEngine::update_stats() {
+    stats_.embedding_runs = get_embedding_runs();
+    if (cascade_) {
+        stats_.cascade_items = cascade_->assigned_count();
+        stats_.cascade_escalated = cascade_->escalated_count();
+    }
+    if (deadline_->active()) {
+        stats_.elapsed_seconds = deadline_->elapsed();
+        stats_.degradations = deadline_->applied();
+    }
+    if (profiler_) {
+        profiler_->end();
+        stats_.profile = profiler_->stages();
+        stats_.profile_units = profiler_->units();
+    }
+}
+
+std::vector<AudioSegment> DiarizationEngine::process_audio(const AudioBuffer& audio, const DiarizeOptions& options) {
     std::vector<AudioSegment> segments;
+    embedding_run_base_ = embedder_->get_inference_count() + 
+                          (small_embedder_ ? small_embedder_->get_inference_count() : 0);
+    stats_ = DiarizeStats();
+    stats_.processed_samples = static_cast<SampleIndex>(audio.size());
+    stats_.deadline_seconds = options.deadline;
+    deadline_ = std::make_unique<DeadlineGovernor>(options.deadline, verbose_);
+    
+    // Every call is an independent job: speakers of a previous recording must not leak into this one
+    if (cascade_) {
+        cascade_->reset();
+    } else {
+        embedder_->reset_speakers();
+    }
     
     try {
         if (verbose_) {
@@ -50,13 +279,26 @@ std::vector<AudioSegment> DiarizationEngine::process_audio(const std::vector<flo
                      << static_cast<float>(audio.size()) / options.sample_rate << " seconds)" << std::endl;
         }
         
+        if (options.mode != "uniform" && options.mode != "changepoint") {
+            segments = diarize_tracks(audio, options);
+            update_stats();
+            return segments;
+        }
+        
+        if (options.mode == "uniform") {
+            segments = diarize_uniform(audio, options);
+            update_stats();
+            return segments;
+        }
+        
         // Step 1: Detect speaker change points
         auto change_points = detect_speaker_changes(audio, options);
         
         if (verbose_) {
             std::cout << "🔍 Detected " << change_points.size() << " speaker change points" << std::endl;
             for (size_t i = 0; i < change_points.size(); i++) {
-                std::cout << "   Change point " << (i+1) << ": " << change_points[i] << "s" << std::endl;
+                std::cout << "   Change point " << (i+1) << ": " 
+                         << Utils::Time::samples_to_seconds(change_points[i], options.sample_rate) << "s" << std::endl;
             }
         }
         
@@ -66,14 +308,18 @@ std::vector<AudioSegment> DiarizationEngine::process_audio(const std::vector<flo
         if (verbose_) {
             std::cout << "📝 Created " << audio_segments.size() << " audio segments" << std::endl;
             for (size_t i = 0; i < audio_segments.size(); i++) {
-                std::cout << "   Segment " << (i+1) << ": " << audio_segments[i].start_time 
-                         << "s - " << audio_segments[i].end_time << "s ("
-                         << (audio_segments[i].end_time - audio_segments[i].start_time) << "s)" << std::endl;
+                const auto& seg = audio_segments[i];
+                std::cout << "   Segment " << (i+1) << ": " 
+                         << Utils::Time::samples_to_seconds(seg.start_sample, options.sample_rate) << "s - " 
+                         << Utils::Time::samples_to_seconds(seg.end_sample, options.sample_rate) << "s ("
+                         << Utils::Time::samples_to_seconds(seg.end_sample - seg.start_sample, options.sample_rate) 
+                         << "s)" << std::endl;
             }
         }
         
         // Step 3: Assign speakers
         segments = assign_speakers(audio_segments, options);
+        update_stats();
         
         if (verbose_) {
             std::cout << "👥 Assigned " << embedder_->get_speaker_count() << " unique speakers" << std::endl;
@@ -86,7 +332,870 @@ std::vector<AudioSegment> DiarizationEngine::process_audio(const std::vector<flo
     return segments;
 }
 
-std::vector<float> DiarizationEngine::detect_speaker_changes(const std::vector<float>& audio, const DiarizeOptions& options) {
+std::vector<AudioSegment> DiarizationEngine::diarize_tracks(const AudioBuffer& audio, const DiarizeOptions& options) {
+    if (!segmenter_->is_initialized() || (options.mode != "fast" && !embedder_->is_initialized())) {
+        std::cerr << "❌ Diarization engine not initialized" << std::endl;
+        return {};
+    }
+    
+    const SampleIndex total_samples = static_cast<SampleIndex>(audio.size());
+    
+    // Step 1: Decode local speaker activity per window and link it into tracks
+    reduced_embeddings_.clear();
+    DiarizeState state;
+    load_state(audio, options, state);
+    checkpoint_ = options.checkpoint_path.empty() ? nullptr 
+                                                 : std::make_unique<CheckpointSchedule>(options.checkpoint_interval);
+    
+    SpeakerTracker tracker(segmenter_->get_window_size(), kLinkThreshold, kActivityThreshold, verbose_);
+    pin_to_segmentation_cores();
+    const SampleIndex segmented_samples = track_speakers(audio, options, tracker, state);
+    const auto& tracks = tracker.tracks();
+    
+    if (verbose_) {
+        std::cout << "🧵 Linked local speakers into " << tracks.size() << " tracks ("
+                 << tracker.link_count() << " cross-window links)" << std::endl;
+    }
+    
+    // Cancelled: label what was segmented without embeddings and keep the checkpoint for --resume
+    auto partial_result = [&](SampleIndex processed_samples) {
+        if (checkpoint_) {
+            save_state(audio, options, tracker, nullptr, state, options.checkpoint_path, false);
+            checkpoint_.reset();
+        }
+        stats_.cancelled = true;
+        stats_.processed_samples = processed_samples;
+        
+        std::vector<int> speaker_ids(tracks.size(), 0);
+        std::vector<float> confidence(tracks.size(), 0.5f);
+        label_tracks(tracks, options, speaker_ids, confidence);
+        return tracks_to_segments(tracks, tracker, speaker_ids, confidence, processed_samples, options);
+    };
+    if (cancelled_) {
+        if (verbose_) {
+            std::cout << "⏹️ Cancelled after " 
+                     << Utils::Time::samples_to_seconds(segmented_samples, options.sample_rate) << "s" << std::endl;
+        }
+        return partial_result(segmented_samples);
+    }
+    
+    if (tracks.empty()) {
+        if (verbose_) {
+            std::cout << "⚠️ No speech detected" << std::endl;
+        }
+        discard_checkpoint(options);
+        return {};
+    }
+    
+    std::vector<int> track_speaker_ids(tracks.size(), 0);
+    std::vector<float> track_confidence(tracks.size(), 0.5f);
+    
+    // Fast mode (or a deadline that leaves no time for embeddings): labels come from the segmentation model alone
+    auto label_only = [&]() {
+        finish_state(audio, options, tracker, {}, state);
+        label_tracks(tracks, options, track_speaker_ids, track_confidence);
+        auto segments = tracks_to_segments(tracks, tracker, track_speaker_ids, track_confidence, total_samples, options);
+        discard_checkpoint(options);
+        return segments;
+    };
+    if (options.mode == "fast" || deadline_->skip_embeddings()) {
+        return label_only();
+    }
+    
+    // Number of tracks speaking on each frame, used to pick clean (non-overlapped) audio
+    const int64_t total_frames = tracker.sample_to_frame(total_samples) + 1;
+    std::vector<uint8_t> active_tracks(static_cast<size_t>(total_frames), 0);
+    for (const auto& track : tracks) {
+        for (int64_t g = track.first_frame; g < std::min(track.end_frame(), total_frames); g++) {
+            if (track.activity(g) >= kActivityThreshold && active_tracks[g] < 255) {
+                active_tracks[g]++;
+            }
+        }
+    }
+    
+    // Step 2: One embedding per track, all crops of a track in a single model run
+    pin_to_embedding_cores();
+    // (with a cascade, the small model embeds every track and the large one only ambiguous ones)
+    SpeakerEmbedder& embedder = cascade_ ? *small_embedder_ : *embedder_;
+    auto crop_source = [&](size_t i) {
+        const size_t max_crops = deadline_->fewer_crops() ? 1 : kMaxTrackCrops;
+        return [&audio, &tracks, &tracker, &active_tracks, this, i, max_crops](size_t target_length) {
+            return track_crops(audio, tracks[i], tracker, active_tracks, target_length, max_crops);
+        };
+    };
+    
+    std::vector<std::vector<float>> embeddings(tracks.size());
+    reduced_embeddings_.assign(tracks.size(), 0);
+    std::vector<size_t> speech_frames(tracks.size(), 0);
+    size_t reused_embeddings = 0;
+    for (size_t i = 0; i < tracks.size(); i++) {
+        for (int64_t g = tracks[i].first_frame; g < tracks[i].end_frame(); g++) {
+            if (tracks[i].activity(g) >= kActivityThreshold) {
+                speech_frames[i]++;
+            }
+        }
+        
+        // Tracks already embedded by a checkpoint, or that ended before the previous run's tail
+        const auto* cached = state.find_embedding(tracks[i].id, tracks[i].first_frame, tracks[i].window_count);
+        if (cached && cached->size() == embedder.get_embedding_dimension()) {
+            embeddings[i] = *cached;
+            reused_embeddings++;
+        }
+    }
+    
+    begin_stage("embedding");
+    size_t tracks_left = tracks.size() - reused_embeddings;
+    size_t measured_tracks = 0;
+    auto measure_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < tracks.size(); i++) {
+        if (embeddings[i].empty()) {
+            if (deadline_->skip_embeddings()) {
+                return label_only();
+            }
+            
+            reduced_embeddings_[i] = deadline_->fewer_crops();
+            const auto crops = crop_source(i)(embedder.get_target_length());
+            {
+                ProfileScope unit(profiler_, "embedding_batch");
+                embeddings[i] = embedder.extract_mean_embedding(crops);
+            }
+            if (cancelled_) {
+                // The aborted run left no usable embedding; the checkpoint keeps the finished ones
+                embeddings[i].clear();
+                if (checkpoint_) {
+                    save_state(audio, options, tracker, &embeddings, state, options.checkpoint_path, false);
+                }
+                return partial_result(total_samples);
+            }
+            write_checkpoint(audio, options, tracker, &embeddings, state);
+            
+            tracks_left--;
+            measured_tracks++;
+            if (deadline_->active()) {
+                const bool fewer_crops = deadline_->fewer_crops();
+                deadline_->plan_embedding(measured_tracks, std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - measure_start).count(), tracks_left);
+                if (deadline_->fewer_crops() != fewer_crops) {
+                    // Throughput changes with the setting, measure it afresh
+                    measured_tracks = 0;
+                    measure_start = std::chrono::steady_clock::now();
+                }
+            }
+        }
+        if (progress_) progress_->update(static_cast<double>(i + 1) / tracks.size());
+    }
+    
+    if (verbose_) {
+        std::cout << "🧮 Embedded " << tracks.size() - reused_embeddings << " tracks with " << get_embedding_runs() 
+                 << " embedding model runs";
+        if (reused_embeddings > 0) {
+            std::cout << " (" << reused_embeddings << " cached)";
+        }
+        std::cout << std::endl;
+    }
+    
+    finish_state(audio, options, tracker, embeddings, state);
+    
+    // Step 3: Cluster tracks into speakers, longest tracks first so centroids start out stable
+    begin_stage("clustering");
+    float assignment_threshold = std::max(0.3f, options.threshold);
+    std::vector<size_t> order(tracks.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&speech_frames](size_t a, size_t b) {
+        return speech_frames[a] > speech_frames[b];
+    });
+    
+    for (size_t i : order) {
+        ProfileScope unit(profiler_, "cluster_update");
+        track_speaker_ids[i] = cascade_ 
+            ? cascade_->assign(embeddings[i], crop_source(i), assignment_threshold, options.max_speakers)
+            : embedder.find_or_create_speaker(embeddings[i], assignment_threshold, options.max_speakers);
+    }
+    
+    for (size_t i = 0; i < tracks.size(); i++) {
+        track_confidence[i] = embedder.calculate_confidence(embeddings[i], track_speaker_ids[i]);
+    }
+    
+    if (verbose_) {
+        std::cout << "👥 Assigned " << embedder.get_speaker_count() << " unique speakers" << std::endl;
+    }
+    
+    // Step 4: Binarize track activity into (possibly overlapping) speaker segments
+    auto segments = tracks_to_segments(tracks, tracker, track_speaker_ids, track_confidence, total_samples, options);
+    discard_checkpoint(options);
+    return segments;
+}
+
+void DiarizationEngine::label_tracks(const std::vector<SpeakerTrack>& tracks,
+                                     const DiarizeOptions& options,
+                                     std::vector<int>& track_speaker_ids,
+                                     std::vector<float>& track_confidence) {
+    // Tracks already carry the permutation matching done on window overlaps, which is the
+    // only evidence of identity without embeddings: a track that was not linked is a new
+    // speaker. Past max_speakers, fold it into a speaker it never shares a window with.
+    std::vector<size_t> order(tracks.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&tracks](size_t a, size_t b) {
+        return tracks[a].first_frame < tracks[b].first_frame;
+    });
+    
+    std::vector<int64_t> speaker_last_frame;  // Last frame of each speaker's latest track
+    std::fill(track_speaker_ids.begin(), track_speaker_ids.end(), -1);
+    
+    for (size_t i : order) {
+        const auto& track = tracks[i];
+        
+        int best = -1;
+        if (static_cast<int>(speaker_last_frame.size()) < options.max_speakers) {
+            best = static_cast<int>(speaker_last_frame.size());
+            speaker_last_frame.push_back(track.end_frame());
+        } else {
+            std::vector<bool> blocked(speaker_last_frame.size(), false);
+            for (int other : track.conflicts) {
+                int speaker = track_speaker_ids[other];
+                if (speaker >= 0) blocked[speaker] = true;
+            }
+            
+            // Over the limit: the compatible speaker silent the longest, or any if none is compatible
+            for (size_t s = 0; s < speaker_last_frame.size(); s++) {
+                if (!blocked[s] && (best < 0 || speaker_last_frame[s] < speaker_last_frame[best])) {
+                    best = static_cast<int>(s);
+                }
+            }
+            if (best < 0) {
+                best = static_cast<int>(std::min_element(speaker_last_frame.begin(), speaker_last_frame.end()) 
+                                        - speaker_last_frame.begin());
+            }
+        }
+        
+        track_speaker_ids[i] = best;
+        speaker_last_frame[best] = std::max(speaker_last_frame[best], track.end_frame());
+        
+        // Confidence is the mean segmentation activity over the track's speech frames
+        double activity_sum = 0.0;
+        size_t speech_frames = 0;
+        for (int64_t g = track.first_frame; g < track.end_frame(); g++) {
+            float activity = track.activity(g);
+            if (activity >= kActivityThreshold) {
+                activity_sum += activity;
+                speech_frames++;
+            }
+        }
+        track_confidence[i] = speech_frames ? static_cast<float>(activity_sum / speech_frames) : 0.5f;
+    }
+    
+    if (verbose_) {
+        std::cout << "👥 Labeled " << tracks.size() << " tracks as " << speaker_last_frame.size() 
+                 << " speakers without embeddings" << std::endl;
+    }
+}
+
+DiarizeState DiarizationEngine::state_settings(const DiarizeOptions& options) const {
+    DiarizeState settings;
+    settings.mode = options.mode;
+    settings.embedding_model = cascade_ ? options.small_embedding_model_path : options.embedding_model_path;
+    settings.embedding_duration = options.embedding_duration;
+    settings.sample_rate = options.sample_rate;
+    settings.window_size = segmenter_->get_window_size();
+    settings.hop_size = segmenter_->get_hop_size();
+    return settings;
+}
+
+bool DiarizationEngine::read_state(const std::string& path, const AudioBuffer& audio,
+                                   const DiarizeOptions& options, bool exact, DiarizeState& state) {
+    if (!Utils::FileSystem::file_exists(path) || !state.load(path)) {
+        return false;
+    }
+    
+    std::string reason;
+    if (!state.applies_to(audio, state_settings(options), exact, reason)) {
+        if (verbose_) {
+            std::cout << "⚠️ Ignoring " << path << " (" << reason << ")" << std::endl;
+        }
+        state = DiarizeState();
+        return false;
+    }
+    
+    return true;
+}
+
+bool DiarizationEngine::load_state(const AudioBuffer& audio, const DiarizeOptions& options, DiarizeState& state) {
+    // A checkpoint of this same job supersedes the state of an earlier, shorter recording
+    if (options.resume && !options.checkpoint_path.empty() && 
+        read_state(options.checkpoint_path, audio, options, true, state)) {
+        if (verbose_) {
+            std::cout << "⏯️ Resuming from checkpoint: " << state.windows.size() << " windows, "
+                     << state.track_embeddings.size() << " track embeddings" << std::endl;
+        }
+        return true;
+    }
+    
+    if (!options.state_path.empty() && read_state(options.state_path, audio, options, false, state)) {
+        if (verbose_) {
+            std::cout << "♻️ Resuming from state: " 
+                     << Utils::Time::samples_to_seconds(state.audio_samples, options.sample_rate) << "s already processed" 
+                     << std::endl;
+        }
+        return true;
+    }
+    
+    return false;
+}
+
+void DiarizationEngine::save_state(const AudioBuffer& audio, const DiarizeOptions& options,
+                                   const SpeakerTracker& tracker,
+                                   const std::vector<std::vector<float>>* embeddings,
+                                   DiarizeState& state,
+                                   const std::string& path,
+                                   bool stable_only) {
+    state.prefix_hash = DiarizeState::hash_prefix(audio, audio.size());
+    state.audio_samples = static_cast<int64_t>(audio.size());
+    
+    DiarizeState settings = state_settings(options);
+    state.mode = settings.mode;
+    state.embedding_model = settings.embedding_model;
+    state.embedding_duration = settings.embedding_duration;
+    state.sample_rate = settings.sample_rate;
+    state.window_size = settings.window_size;
+    state.hop_size = settings.hop_size;
+    
+    // Without new embeddings (segmentation phase) the cached ones are kept as they are
+    if (embeddings) {
+        // Tracks reaching past the last stable window may still change when the recording grows,
+        // and past the windows kept under a deadline they were built from degraded windows
+        const auto& tracks = tracker.tracks();
+        const int64_t stable_end_frame = state.windows.empty() ? 0 :
+            tracker.sample_to_frame(state.windows.back().start_sample) + static_cast<int64_t>(tracker.frames_per_window());
+        const bool degraded_windows = deadline_->skip_silence() || deadline_->hop_scale() != 1.0f;
+        
+        state.track_embeddings.clear();
+        for (size_t i = 0; i < tracks.size() && i < embeddings->size(); i++) {
+            if ((*embeddings)[i].empty()) continue;
+            if ((stable_only || degraded_windows) && tracks[i].end_frame() > stable_end_frame) continue;
+            if (i < reduced_embeddings_.size() && reduced_embeddings_[i]) continue;  // Deadline cut its crops
+            state.track_embeddings.push_back({tracks[i].id, tracks[i].first_frame, tracks[i].window_count, (*embeddings)[i]});
+        }
+    }
+    
+    if (state.save(path) && verbose_ && stable_only) {
+        std::cout << "💾 Saved state: " << state.windows.size() << " windows, " 
+                 << state.track_embeddings.size() << " track embeddings" << std::endl;
+    }
+}
+
+void DiarizationEngine::finish_state(const AudioBuffer& audio, const DiarizeOptions& options,
+                                     const SpeakerTracker& tracker,
+                                     const std::vector<std::vector<float>>& embeddings,
+                                     DiarizeState& state) {
+    if (!options.state_path.empty()) {
+        save_state(audio, options, tracker, &embeddings, state, options.state_path, true);
+    }
+}
+
+void DiarizationEngine::discard_checkpoint(const DiarizeOptions& options) {
+    // The job completed, its checkpoint must not be resumed by a later run
+    if (checkpoint_) {
+        if (verbose_ && checkpoint_->write_count() > 0) {
+            std::cout << "💾 Wrote " << checkpoint_->write_count() << " checkpoints in " 
+                     << std::fixed << std::setprecision(2) << checkpoint_->write_seconds() << "s" << std::endl;
+        }
+        std::remove(options.checkpoint_path.c_str());
+        checkpoint_.reset();
+    }
+}
+
+void DiarizationEngine::write_checkpoint(const AudioBuffer& audio, const DiarizeOptions& options,
+                                         const SpeakerTracker& tracker,
+                                         const std::vector<std::vector<float>>* embeddings,
+                                         DiarizeState& state) {
+    if (!checkpoint_ || !checkpoint_->due()) {
+        return;
+    }
+    
+    auto started = CheckpointSchedule::now();
+    save_state(audio, options, tracker, embeddings, state, options.checkpoint_path, false);
+    checkpoint_->record_write(started);
+}
+
+SampleIndex DiarizationEngine::track_speakers(const AudioBuffer& audio, const DiarizeOptions& options,
+                                              SpeakerTracker& tracker, DiarizeState& state) {
+    std::vector<WindowActivity>& stable_windows = state.windows;
+    const size_t window_size = static_cast<size_t>(segmenter_->get_window_size());
+    const size_t hop_size = static_cast<size_t>(segmenter_->get_hop_size());
+    
+    size_t total_windows = 1;
+    if (audio.size() > window_size) {
+        total_windows = (audio.size() - window_size + hop_size - 1) / hop_size + 1;
+    }
+    
+    // Replay windows cached by an earlier run on a prefix of this recording
+    size_t first_start = 0;
+    for (const auto& window : stable_windows) {
+        tracker.add_window(window);
+    }
+    if (!stable_windows.empty()) {
+        first_start = static_cast<size_t>(stable_windows.back().start_sample) + hop_size;
+        if (verbose_) {
+            std::cout << "♻️ Reused " << stable_windows.size() << " cached segmentation windows" << std::endl;
+        }
+    }
+    
+    // Windows cover the whole file; the last one is zero-padded by the segmenter
+    begin_stage("segmentation");
+    size_t processed_windows = stable_windows.size();
+    
+    // One pass over the recording for block peaks; window gains are read from them, not rescanned
+    AudioGain gain;
+    gain.analyze(audio);
+    size_t processed_end = stable_windows.empty() ? 0 : std::min(audio.size(), first_start - hop_size + window_size);
+    
+    // Under a deadline, measured throughput may enable silence skipping or a larger hop
+    size_t step = hop_size;
+    size_t segmented_windows = 0;
+    const auto segmentation_start = std::chrono::steady_clock::now();
+    std::vector<float> block_rms;
+    float loud_rms = 0.0f;
+    auto window_rms = [&audio](size_t begin, size_t end) {
+        double energy = 0.0;
+        for (size_t n = begin; n < end; n++) {
+            energy += static_cast<double>(audio[n]) * audio[n];
+        }
+        return static_cast<float>(std::sqrt(energy / std::max<size_t>(1, end - begin)));
+    };
+    auto is_silent = [&](float rms) {
+        return rms <= 1e-4f || rms < kSilenceRatio * loud_rms;
+    };
+    auto silent_fraction = [&](size_t from) {
+        // Hop-sized blocks give the loudness reference and the share of silence still ahead
+        if (block_rms.empty()) {
+            for (size_t begin = 0; begin < audio.size(); begin += hop_size) {
+                block_rms.push_back(window_rms(begin, std::min(begin + hop_size, audio.size())));
+            }
+            std::vector<float> sorted_rms = block_rms;
+            std::sort(sorted_rms.begin(), sorted_rms.end());
+            loud_rms = sorted_rms[sorted_rms.size() * 95 / 100];
+        }
+        size_t silent = 0;
+        size_t total = 0;
+        for (size_t b = from / hop_size; b < block_rms.size(); b++, total++) {
+            if (is_silent(block_rms[b])) silent++;
+        }
+        return total ? static_cast<double>(silent) / total : 0.0;
+    };
+    
+    // Windows are segmented in batches; silence skipping is decided when a window joins a batch
+    struct PendingWindow {
+        size_t start;
+        size_t end;
+        bool skipped;
+    };
+    const size_t batch_size = static_cast<size_t>(std::max(1, options.segmentation_batch_size));
+    size_t next_start = first_start;
+    bool reached_end = first_start >= audio.size();
+    
+    // Windows are kept only when a state file or checkpoint will be written, and only up to
+    // the first window a deadline skipped or moved off the hop grid: a later run without a
+    // deadline must not resume from degraded posteriors
+    bool keep_windows = !options.state_path.empty() || checkpoint_;
+    size_t next_kept_start = first_start;
+    
+    // Reused across batches: windows are read straight from the audio and activities keep their buffers
+    std::vector<PendingWindow> pending;
+    std::vector<int64_t> batch_starts;
+    std::vector<WindowActivity> activities;
+    
+    while (!reached_end && !cancelled_) {
+        pending.clear();
+        batch_starts.clear();
+        while (batch_starts.size() < batch_size && !reached_end) {
+            size_t end = std::min(next_start + window_size, audio.size());
+            bool skipped = deadline_->skip_silence() && is_silent(window_rms(next_start, end));
+            pending.push_back({next_start, end, skipped});
+            if (!skipped) {
+                batch_starts.push_back(static_cast<int64_t>(next_start));
+            }
+            reached_end = end == audio.size();
+            next_start += step;
+        }
+        
+        // Steady-state unit for allocation budgets: the batch's inference
+        {
+            ProfileScope unit(profiler_, "window_batch");
+            segmenter_->process_windows_activity(audio, gain, batch_starts, batch_size, activities);
+        }
+        if (cancelled_) {
+            break;  // The batch's inference was aborted, its activity is incomplete
+        }
+        
+        size_t b = 0;
+        for (const auto& window : pending) {
+            processed_end = window.end;
+            processed_windows++;
+            if (window.skipped || window.start != next_kept_start) {
+                keep_windows = false;
+            }
+            if (window.skipped) {
+                continue;
+            }
+            
+            auto& activity = activities[b++];
+            tracker.add_window(activity);
+            
+            // Only windows fully inside the audio stay valid when the recording grows
+            if (keep_windows && window.start + window_size <= audio.size()) {
+                stable_windows.push_back(activity);
+                next_kept_start += hop_size;
+                write_checkpoint(audio, options, tracker, nullptr, state);
+            }
+            segmented_windows++;
+        }
+        
+        if (deadline_->active() && !reached_end) {
+            const size_t windows_left = (audio.size() - processed_end) / step + 1;
+            deadline_->plan_segmentation(segmented_windows, std::chrono::duration<double>(
+                                             std::chrono::steady_clock::now() - segmentation_start).count(),
+                                         windows_left, silent_fraction(next_start), options.mode != "fast");
+            step = static_cast<size_t>(hop_size * deadline_->hop_scale());
+        }
+        if (progress_) progress_->update(static_cast<double>(processed_end) / audio.size());
+        if (verbose_) {
+            float progress = static_cast<float>(processed_windows) / total_windows * 100.0f;
+            std::cout << "\rSegmentation progress: " << std::fixed << std::setprecision(1) 
+                     << std::min(progress, 100.0f) << "%" << std::flush;
+        }
+    }
+    
+    if (verbose_) {
+        std::cout << std::endl;
+    }
+    
+    return static_cast<SampleIndex>(processed_end);
+}
+
+std::vector<std::vector<float>> DiarizationEngine::track_crops(const AudioBuffer& audio,
+                                                               const SpeakerTrack& track,
+                                                               const SpeakerTracker& tracker,
+                                                               const std::vector<uint8_t>& active_tracks,
+                                                               size_t target_length,
+                                                               size_t max_crops) {
+    const size_t max_samples = target_length * max_crops;
+    const int64_t last_frame = std::min(track.end_frame(), static_cast<int64_t>(active_tracks.size()));
+    
+    // Collect the track's speech, preferring frames where nobody else is talking
+    auto gather = [&](bool clean_only) {
+        std::vector<float> speech;
+        for (int64_t g = track.first_frame; g < last_frame && speech.size() < max_samples; g++) {
+            if (track.activity(g) < kActivityThreshold) continue;
+            if (clean_only && active_tracks[g] > 1) continue;
+            
+            size_t begin = static_cast<size_t>(std::max<int64_t>(0, tracker.frame_to_sample(g)));
+            size_t end = std::min(static_cast<size_t>(tracker.frame_to_sample(g + 1)), audio.size());
+            if (begin >= end) continue;
+            end = std::min(end, begin + (max_samples - speech.size()));
+            const size_t copied = speech.size();
+            speech.resize(copied + end - begin);
+            audio.read(begin, end - begin, speech.data() + copied);
+        }
+        return speech;
+    };
+    
+    auto speech = gather(true);
+    if (speech.size() < target_length / 2) {
+        auto overlapped = gather(false);
+        if (overlapped.size() > speech.size()) {
+            speech = std::move(overlapped);
+        }
+    }
+    
+    // Full crops, plus a short remainder only when it is the sole crop
+    std::vector<std::vector<float>> crops;
+    for (size_t offset = 0; offset < speech.size() || crops.empty(); offset += target_length) {
+        size_t end = std::min(offset + target_length, speech.size());
+        if (!crops.empty() && end - offset < target_length / 2) {
+            break;
+        }
+        crops.emplace_back(speech.begin() + offset, speech.begin() + end);
+        if (end == speech.size()) {
+            break;
+        }
+    }
+    
+    return crops;
+}
+
+std::vector<AudioSegment> DiarizationEngine::tracks_to_segments(const std::vector<SpeakerTrack>& tracks,
+                                                                const SpeakerTracker& tracker,
+                                                                const std::vector<int>& track_speaker_ids,
+                                                                const std::vector<float>& track_confidence,
+                                                                SampleIndex total_samples,
+                                                                const DiarizeOptions& options) {
+    const SampleIndex min_speech = static_cast<SampleIndex>(kMinSpeechDuration * options.sample_rate);
+    const SampleIndex max_gap = static_cast<SampleIndex>(kMaxMergeGap * options.sample_rate);
+    
+    // Speech runs per speaker: tracks of the same speaker may overlap where windows were not linked
+    std::map<int, std::vector<AudioSegment>> runs;
+    std::vector<float> activity;
+    std::vector<Signal::Region> regions;
+    for (size_t i = 0; i < tracks.size(); i++) {
+        const auto& track = tracks[i];
+        
+        activity.clear();
+        for (int64_t g = track.first_frame; g < track.end_frame(); g++) {
+            activity.push_back(track.activity(g));
+        }
+        regions.clear();
+        Signal::Hysteresis binarizer(kActivityThreshold, kActivityThreshold);
+        binarizer.push(activity.data(), activity.size(), regions);
+        binarizer.finish(regions);
+        
+        for (const auto& region : regions) {
+            AudioSegment segment;
+            segment.start_sample = std::min(tracker.frame_to_sample(track.first_frame + static_cast<int64_t>(region.start)), total_samples);
+            segment.end_sample = std::min(tracker.frame_to_sample(track.first_frame + static_cast<int64_t>(region.end)), total_samples);
+            segment.speaker_id = track_speaker_ids[i];
+            segment.confidence = track_confidence[i];
+            if (segment.end_sample > segment.start_sample) {
+                runs[segment.speaker_id].push_back(segment);
+            }
+        }
+    }
+    
+    std::vector<AudioSegment> segments;
+    for (auto& [speaker_id, speaker_runs] : runs) {
+        std::sort(speaker_runs.begin(), speaker_runs.end(), [](const AudioSegment& a, const AudioSegment& b) {
+            return a.start_sample < b.start_sample;
+        });
+        
+        // Union overlapping runs and bridge short pauses; confidence is duration-weighted
+        std::vector<AudioSegment> merged;
+        double weighted_confidence = 0.0;
+        SampleIndex covered = 0;
+        for (const auto& run : speaker_runs) {
+            SampleIndex length = run.end_sample - run.start_sample;
+            if (!merged.empty() && run.start_sample <= merged.back().end_sample + max_gap) {
+                merged.back().end_sample = std::max(merged.back().end_sample, run.end_sample);
+            } else {
+                if (!merged.empty()) {
+                    merged.back().confidence = static_cast<float>(weighted_confidence / std::max<SampleIndex>(1, covered));
+                }
+                merged.push_back(run);
+                weighted_confidence = 0.0;
+                covered = 0;
+            }
+            weighted_confidence += static_cast<double>(run.confidence) * length;
+            covered += length;
+        }
+        if (!merged.empty()) {
+            merged.back().confidence = static_cast<float>(weighted_confidence / std::max<SampleIndex>(1, covered));
+        }
+        
+        for (auto& segment : merged) {
+            if (segment.end_sample - segment.start_sample >= min_speech) {
+                segments.push_back(std::move(segment));
+            }
+        }
+    }
+    
+    std::sort(segments.begin(), segments.end(), [](const AudioSegment& a, const AudioSegment& b) {
+        return a.start_sample != b.start_sample ? a.start_sample < b.start_sample : a.speaker_id < b.speaker_id;
+    });
+    
+    if (verbose_) {
+        std::cout << "📝 Created " << segments.size() << " speaker segments" << std::endl;
+    }
+    
+    return segments;
+}
+
+std::vector<AudioSegment> DiarizationEngine::diarize_uniform(const AudioBuffer& audio, const DiarizeOptions& options) {
+    if (!embedder_->is_initialized()) {
+        std::cerr << "❌ Speaker embedder not initialized" << std::endl;
+        return {};
+    }
+    
+    SpeakerEmbedder& embedder = cascade_ ? *small_embedder_ : *embedder_;
+    const SampleIndex total_samples = static_cast<SampleIndex>(audio.size());
+    const SampleIndex window = static_cast<SampleIndex>(embedder.get_target_length());
+    pin_to_embedding_cores();
+    const SampleIndex hop = std::max<SampleIndex>(1, window / 2);
+    
+    // Step 1: Fixed overlapping windows over the whole file
+    std::vector<SampleIndex> starts;
+    for (SampleIndex start = 0; start < total_samples; start += hop) {
+        starts.push_back(start);
+        if (start + window >= total_samples) break;
+    }
+    
+    // Without a segmentation model, an energy gate stands in for speech detection
+    std::vector<float> rms(starts.size(), 0.0f);
+    for (size_t i = 0; i < starts.size(); i++) {
+        SampleIndex end = std::min(starts[i] + window, total_samples);
+        double energy = 0.0;
+        for (SampleIndex n = starts[i]; n < end; n++) {
+            energy += static_cast<double>(audio[n]) * audio[n];
+        }
+        rms[i] = static_cast<float>(std::sqrt(energy / std::max<SampleIndex>(1, end - starts[i])));
+    }
+    
+    std::vector<float> sorted_rms = rms;
+    std::sort(sorted_rms.begin(), sorted_rms.end());
+    const float loud_rms = sorted_rms.empty() ? 0.0f : sorted_rms[sorted_rms.size() * 95 / 100];
+    
+    std::vector<size_t> speech_windows;
+    for (size_t i = 0; i < starts.size(); i++) {
+        if (rms[i] > 1e-4f && rms[i] >= kSilenceRatio * loud_rms) {
+            speech_windows.push_back(i);
+        }
+    }
+    
+    if (verbose_) {
+        std::cout << "🪟 Uniform mode: " << starts.size() << " windows of "
+                 << Utils::Time::samples_to_seconds(window, options.sample_rate) << "s, "
+                 << speech_windows.size() << " with speech" << std::endl;
+    }
+    
+    if (speech_windows.empty()) {
+        return {};
+    }
+    
+    // Step 2: Batched embeddings, one batch per call so a cancellation stops between batches.
+    // Crops are cut per batch: only one batch of window copies is alive at a time.
+    begin_stage("embedding");
+    const size_t chunk = static_cast<size_t>(std::max(1, options.embedding_batch_size));
+    std::vector<std::vector<float>> embeddings;
+    embeddings.reserve(speech_windows.size());
+    for (size_t first = 0; first < speech_windows.size(); first += chunk) {
+        std::vector<std::vector<float>> batch;
+        for (size_t t = first; t < std::min(first + chunk, speech_windows.size()); t++) {
+            SampleIndex start = starts[speech_windows[t]];
+            batch.emplace_back(static_cast<size_t>(std::min(start + window, total_samples) - start));
+            audio.read(static_cast<size_t>(start), batch.back().size(), batch.back().data());
+        }
+        auto batch_embeddings = embedder.extract_embeddings(batch, options.embedding_batch_size);
+        if (cancelled_) {
+            break;
+        }
+        for (auto& embedding : batch_embeddings) {
+            embeddings.push_back(std::move(embedding));
+        }
+        if (progress_) progress_->update(static_cast<double>(embeddings.size()) / speech_windows.size());
+    }
+    
+    // Cancelled: diarize the windows embedded so far
+    if (cancelled_) {
+        stats_.cancelled = true;
+        speech_windows.resize(embeddings.size());
+        stats_.processed_samples = embeddings.empty() ? 0 :
+            std::min(starts[speech_windows.back()] + window, total_samples);
+        if (embeddings.empty()) {
+            return {};
+        }
+    }
+    
+    if (verbose_) {
+        std::cout << "🧮 Embedded " << embeddings.size() << " windows with " << get_embedding_runs() 
+                 << " embedding model runs" << std::endl;
+    }
+    
+    // Step 3: Online clustering builds centroids, then every window is re-scored against the final ones
+    begin_stage("clustering");
+    float assignment_threshold = std::max(0.3f, options.threshold);
+    for (size_t t = 0; t < embeddings.size(); t++) {
+        if (!cascade_) {
+            embedder.find_or_create_speaker(embeddings[t], assignment_threshold, options.max_speakers);
+            continue;
+        }
+        
+        // Escalated windows are re-cut at the large model's input length around the same start
+        SampleIndex start = starts[speech_windows[t]];
+        auto window_crop = [&audio, start, total_samples](size_t target_length) {
+            SampleIndex end = std::min(start + static_cast<SampleIndex>(target_length), total_samples);
+            std::vector<std::vector<float>> crops(1, std::vector<float>(static_cast<size_t>(end - start)));
+            audio.read(static_cast<size_t>(start), crops[0].size(), crops[0].data());
+            return crops;
+        };
+        cascade_->assign(embeddings[t], window_crop, assignment_threshold, options.max_speakers);
+    }
+    
+    const size_t num_speakers = embedder.get_speaker_count();
+    const size_t n = embeddings.size();
+    const size_t dim = embedder.get_embedding_dimension();
+    
+    // Centroids as one row-major matrix, so each window's similarities are a single GEMV
+    std::vector<float> centroids(num_speakers * dim, 0.0f);
+    for (size_t k = 0; k < num_speakers; k++) {
+        const auto& centroid = embedder.get_speaker_centroid(static_cast<int>(k));
+        std::copy(centroid.begin(), centroid.begin() + std::min(dim, centroid.size()), centroids.begin() + k * dim);
+    }
+    std::vector<float> similarity(n * num_speakers, 0.0f);
+    for (size_t t = 0; t < n; t++) {
+        if (embeddings[t].size() != dim) continue;
+        SimdKernels::gemv(centroids.data(), num_speakers, dim, embeddings[t].data(), similarity.data() + t * num_speakers);
+    }
+    for (float& value : similarity) {
+        value = std::max(-1.0f, std::min(1.0f, value));
+    }
+    
+    // Step 4: Viterbi smoothing over the speech windows (HMM with a fixed switch penalty)
+    std::vector<float> score(num_speakers, 0.0f);
+    std::vector<float> next_score(num_speakers, 0.0f);
+    std::vector<int> backpointer(n * num_speakers, 0);
+    for (size_t k = 0; k < num_speakers; k++) {
+        score[k] = kEmissionScale * similarity[k];
+    }
+    for (size_t t = 1; t < n; t++) {
+        size_t best_prev = std::max_element(score.begin(), score.end()) - score.begin();
+        for (size_t k = 0; k < num_speakers; k++) {
+            float stay = score[k];
+            float change = score[best_prev] - kSwitchPenalty;
+            bool switched = best_prev != k && change > stay;
+            backpointer[t * num_speakers + k] = static_cast<int>(switched ? best_prev : k);
+            next_score[k] = (switched ? change : stay) + kEmissionScale * similarity[t * num_speakers + k];
+        }
+        std::swap(score, next_score);
+    }
+    
+    std::vector<int> labels(n, 0);
+    labels[n - 1] = static_cast<int>(std::max_element(score.begin(), score.end()) - score.begin());
+    for (size_t t = n - 1; t > 0; t--) {
+        labels[t - 1] = backpointer[t * num_speakers + labels[t]];
+    }
+    
+    // Step 5: Each window owns the central part of its span; merge runs of the same speaker
+    std::vector<AudioSegment> segments;
+    const SampleIndex margin = (window - hop) / 2;
+    for (size_t t = 0; t < n; t++) {
+        size_t i = speech_windows[t];
+        SampleIndex start = (i == 0) ? 0 : std::min(starts[i] + margin, total_samples);
+        SampleIndex end = (i + 1 == starts.size()) ? total_samples : std::min(starts[i + 1] + margin, total_samples);
+        float confidence = (similarity[t * num_speakers + labels[t]] + 1.0f) / 2.0f;
+        
+        if (!segments.empty() && segments.back().speaker_id == labels[t] && segments.back().end_sample == start) {
+            auto& last = segments.back();
+            double last_length = static_cast<double>(last.end_sample - last.start_sample);
+            double length = static_cast<double>(end - start);
+            last.confidence = static_cast<float>((last.confidence * last_length + confidence * length) / 
+                                                 std::max(1.0, last_length + length));
+            last.end_sample = end;
+        } else if (end > start) {
+            AudioSegment segment;
+            segment.start_sample = start;
+            segment.end_sample = end;
+            segment.speaker_id = labels[t];
+            segment.confidence = confidence;
+            segments.push_back(std::move(segment));
+        }
+    }
+    
+    if (verbose_) {
+        std::cout << "👥 Assigned " << num_speakers << " unique speakers, " 
+                 << segments.size() << " segments" << std::endl;
+    }
+    
+    return segments;
+}
+
+std::vector<SampleIndex> DiarizationEngine::detect_speaker_changes(const AudioBuffer& audio, const DiarizeOptions& options) {
     if (!segmenter_->is_initialized()) {
         std::cerr << "❌ Speaker segmenter not initialized" << std::endl;
         return {};
@@ -99,15 +1208,18 @@ std::vector<float> DiarizationEngine::detect_speaker_changes(const std::vector<f
         std::cout << "🔍 Using detection threshold: " << detection_threshold << std::endl;
     }
     
+    begin_stage("segmentation");
+    pin_to_segmentation_cores();
     return segmenter_->detect_change_points(audio, detection_threshold);
 }
 
-std::vector<AudioSegment> DiarizationEngine::create_segments(const std::vector<float>& audio, 
-                                                            const std::vector<float>& change_points,
+std::vector<AudioSegment> DiarizationEngine::create_segments(const AudioBuffer& audio, 
+                                                            const std::vector<SampleIndex>& change_points,
                                                             const DiarizeOptions& options) {
     std::vector<AudioSegment> segments;
     
-    float total_duration = static_cast<float>(audio.size()) / options.sample_rate;
+    const SampleIndex total_samples = static_cast<SampleIndex>(audio.size());
+    const SampleIndex sample_rate = options.sample_rate;
     
     if (change_points.empty()) {
         if (verbose_) {
@@ -115,34 +1227,34 @@ std::vector<AudioSegment> DiarizationEngine::create_segments(const std::vector<f
         }
         
         // FIXED: For long audio without change points, create multiple segments
-        if (total_duration > 30.0f) {
-            // Create 20-30 second segments
-            float segment_duration = 25.0f;
-            for (float start = 0.0f; start < total_duration - 5.0f; start += segment_duration) {
-                float end = std::min(start + segment_duration, total_duration);
+        const SampleIndex segment_length = static_cast<SampleIndex>(options.fallback_segment_duration * sample_rate);
+        if (total_samples > segment_length + 5 * sample_rate) {
+            for (SampleIndex start = 0; start < total_samples - 5 * sample_rate; start += segment_length) {
+                SampleIndex end = std::min(start + segment_length, total_samples);
                 
                 AudioSegment segment;
-                segment.start_time = start;
-                segment.end_time = end;
-                
-                size_t start_sample = static_cast<size_t>(start * options.sample_rate);
-                size_t end_sample = static_cast<size_t>(end * options.sample_rate);
+                segment.start_sample = start;
+                segment.end_sample = end;
                 
-                if (end_sample <= audio.size() && start_sample < end_sample) {
-                    segment.samples.assign(audio.begin() + start_sample, audio.begin() + end_sample);
+                if (start < end) {
+                    segment.samples.resize(static_cast<size_t>(end - start));
+                    audio.read(static_cast<size_t>(start), segment.samples.size(), segment.samples.data());
                     segments.push_back(segment);
                     
                     if (verbose_) {
-                        std::cout << "   Created segment: " << start << "s - " << end << "s" << std::endl;
+                        std::cout << "   Created segment: " 
+                                 << Utils::Time::samples_to_seconds(start, options.sample_rate) << "s - " 
+                                 << Utils::Time::samples_to_seconds(end, options.sample_rate) << "s" << std::endl;
                     }
                 }
             }
         } else {
             // Short audio - treat as single segment
             AudioSegment segment;
-            segment.start_time = 0.0f;
-            segment.end_time = total_duration;
-            segment.samples = audio;
+            segment.start_sample = 0;
+            segment.end_sample = total_samples;
+            segment.samples.resize(audio.size());
+            audio.read(0, audio.size(), segment.samples.data());
             segments.push_back(segment);
         }
         
@@ -150,30 +1262,25 @@ std::vector<AudioSegment> DiarizationEngine::create_segments(const std::vector<f
     }
     
     // Create segments between change points
-    std::vector<float> boundaries = {0.0f};
+    std::vector<SampleIndex> boundaries = {0};
     boundaries.insert(boundaries.end(), change_points.begin(), change_points.end());
-    boundaries.push_back(total_duration);
+    boundaries.push_back(total_samples);
     
     for (size_t i = 0; i < boundaries.size() - 1; i++) {
-        float start = boundaries[i];
-        float end = boundaries[i + 1];
+        SampleIndex start = boundaries[i];
+        SampleIndex end = std::min(boundaries[i + 1], total_samples);
         
         // Ensure minimum segment length
-        if (end - start < 2.0f) {
+        if (end - start < static_cast<SampleIndex>(options.min_segment_duration * sample_rate)) {
             continue;
         }
         
         AudioSegment segment;
-        segment.start_time = start;
-        segment.end_time = end;
-        
-        size_t start_sample = static_cast<size_t>(start * options.sample_rate);
-        size_t end_sample = static_cast<size_t>(end * options.sample_rate);
-        
-        if (end_sample <= audio.size() && start_sample < end_sample) {
-            segment.samples.assign(audio.begin() + start_sample, audio.begin() + end_sample);
-            segments.push_back(segment);
-        }
+        segment.start_sample = start;
+        segment.end_sample = end;
+        segment.samples.resize(static_cast<size_t>(end - start));
+        audio.read(static_cast<size_t>(start), segment.samples.size(), segment.samples.data());
+        segments.push_back(segment);
     }
     
     return segments;
@@ -184,6 +1291,8 @@ std::vector<AudioSegment> DiarizationEngine::assign_speakers(std::vector<AudioSe
         std::cerr << "❌ Speaker embedder not initialized" << std::endl;
         return segments;
     }
+    begin_stage("embedding");
+    pin_to_embedding_cores();
     
     // FIXED: Use lower threshold for speaker assignment
     float assignment_threshold = std::max(0.3f, options.threshold);
@@ -228,15 +1337,137 @@ std::vector<AudioSegment> DiarizationEngine::assign_speakers(std::vector<AudioSe
 
 // ... (other methods remain the same)
 
+// Merge step of a sharded job: reads every shard result, needs neither models nor audio
+static int merge_shards(DiarizeOptions& options) {
+    if (options.shard_dir.empty()) {
+        std::cerr << "❌ Error: --merge-shards needs --shard-dir <DIR>" << std::endl;
+        return 1;
+    }
+    
+    std::vector<ShardResult> shards(1);
+    if (!shards[0].load(ShardResult::file_path(options.shard_dir, 0))) {
+        return 1;
+    }
+    
+    const ShardResult& first = shards[0];
+    for (int i = 1; i < first.shard_count; i++) {
+        ShardResult shard;
+        if (!shard.load(ShardResult::file_path(options.shard_dir, i))) {
+            return 1;
+        }
+        if (shard.shard_index != i || shard.shard_count != first.shard_count || shard.sample_rate != first.sample_rate) {
+            std::cerr << "❌ Shard " << i << " does not belong to the same job as shard 0" << std::endl;
+            return 1;
+        }
+        shards.push_back(std::move(shard));
+    }
+    
+    options.sample_rate = first.sample_rate;
+    ShardMerger merger(std::max(0.3f, options.threshold), options.max_speakers, options.verbose);
+    auto segments = merger.merge(shards);
+    
+    if (options.verbose) {
+        std::cout << "🧩 Merged " << shards.size() << " shards: " << segments.size() << " segments, "
+                 << merger.speaker_count() << " speakers" << std::endl;
+    }
+    
+    if (segments.empty()) {
+        std::cerr << "❌ No segments generated" << std::endl;
+        return 1;
+    }
+    
+    Utils::Json::output_results(segments, options, DiarizeStats());
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     try {
         auto options = Utils::Args::parse_arguments(argc, argv);
         
-        if (options.audio_path.empty() || options.segment_model_path.empty() || options.embedding_model_path.empty()) {
+        if (options.merge_shards) {
+            return merge_shards(options);
+        }
+        
+        // Autotune: benchmark the models on this machine and cache the fastest settings
+        if (options.autotune) {
+            if ((!options.segment_model_path.empty() && !Utils::FileSystem::file_exists(options.segment_model_path)) ||
+                (!options.embedding_model_path.empty() && !Utils::FileSystem::file_exists(options.embedding_model_path))) {
+                std::cerr << "❌ Model not found" << std::endl;
+                return 1;
+            }
+            
+            TuneResult result;
+            Autotuner tuner(options, options.verbose);
+            if (!tuner.run(result) || !Autotuner::save(options.autotune_cache, options, result)) {
+                return 1;
+            }
+            std::cout << "✅ Tuned: --threads " << result.intra_op_threads 
+                     << " --segmentation-batch " << result.segmentation_batch_size
+                     << " --embedding-batch " << result.embedding_batch_size << std::endl;
+            std::cout << "💾 Saved to " << options.autotune_cache << std::endl;
+            return 0;
+        }
+        if (options.shard_count > 0 && 
+            (options.shard_index < 0 || options.shard_index >= options.shard_count || options.shard_dir.empty())) {
+            std::cerr << "❌ Error: --shard I/N needs 0 <= I < N and --shard-dir <DIR>" << std::endl;
+            return 1;
+        }
+        
+        if (options.mode != "standard" && options.mode != "changepoint" && 
+            options.mode != "fast" && options.mode != "uniform") {
+            std::cerr << "❌ Unknown mode: " << options.mode 
+                     << " (expected standard, fast, uniform or changepoint)" << std::endl;
+            return 1;
+        }
+        
+        // Without a usable segmentation model, fall back to the embedding-only uniform mode
+        if (options.mode == "standard" && !options.embedding_model_path.empty() &&
+            (options.segment_model_path.empty() || !Utils::FileSystem::file_exists(options.segment_model_path))) {
+            std::cout << "⚠️ Segmentation model unavailable, falling back to --mode uniform" << std::endl;
+            options.mode = "uniform";
+        }
+        
+        // Fast mode only needs the segmentation model, uniform mode only the embedding model
+        const bool needs_embedding = options.mode != "fast";
+        const bool needs_segmentation = options.mode != "uniform";
+        const bool spool = !options.spool_dir.empty();
+        if ((options.audio_path.empty() && !spool) || 
+            (needs_segmentation && options.segment_model_path.empty()) || 
+            (needs_embedding && options.embedding_model_path.empty())) {
             std::cerr << "❌ Error: --audio, --segment-model, and --embedding-model are required\n";
+            std::cerr << "       (--embedding-model is optional with --mode fast,\n";
+            std::cerr << "        --segment-model is optional with --mode uniform,\n";
+            std::cerr << "        --audio is not used with --spool)\n";
             std::cerr << "Use --help for usage information\n";
             return 1;
         }
+        if (!needs_embedding) {
+            options.embedding_model_path.clear();
+        }
+        if (!needs_segmentation) {
+            options.segment_model_path.clear();
+        }
+        if (!options.state_path.empty() && options.mode != "standard" && options.mode != "fast") {
+            std::cout << "⚠️ --state is only used by the standard and fast modes, ignoring it" << std::endl;
+            options.state_path.clear();
+        }
+        if (!options.checkpoint_path.empty() && options.mode != "standard" && options.mode != "fast") {
+            std::cout << "⚠️ --checkpoint is only used by the standard and fast modes, ignoring it" << std::endl;
+            options.checkpoint_path.clear();
+        }
+        if (options.segment_window <= 0.0f || options.segment_hop <= 0.0f || options.segment_hop > options.segment_window ||
+            options.embedding_duration <= 0.0f || options.fallback_segment_duration <= 0.0f) {
+            std::cerr << "❌ Error: window, hop and segment durations must be positive, with hop <= window\n";
+            return 1;
+        }
+        if (options.deadline > 0.0f && options.mode != "standard" && options.mode != "fast") {
+            std::cout << "⚠️ --deadline only adapts the standard and fast modes, ignoring it" << std::endl;
+            options.deadline = 0.0f;
+        }
+        if (options.resume && options.checkpoint_path.empty()) {
+            std::cerr << "❌ Error: --resume needs --checkpoint <PATH>\n";
+            return 1;
+        }
         
         // FIXED: Validate threshold values and adjust if needed
         if (options.threshold > 0.8f) {
@@ -250,43 +1481,89 @@ int main(int argc, char* argv[]) {
         }
         
         // Validate files exist
-        if (!Utils::FileSystem::file_exists(options.audio_path)) {
+        if (!spool && !Utils::FileSystem::file_exists(options.audio_path)) {
             std::cerr << "❌ Audio file not found: " << options.audio_path << std::endl;
             return 1;
         }
         
-        if (!Utils::FileSystem::file_exists(options.segment_model_path)) {
+        if (needs_segmentation && !Utils::FileSystem::file_exists(options.segment_model_path)) {
             std::cerr << "❌ Segmentation model not found: " << options.segment_model_path << std::endl;
             return 1;
         }
         
-        if (!Utils::FileSystem::file_exists(options.embedding_model_path)) {
+        if (needs_embedding && !Utils::FileSystem::file_exists(options.embedding_model_path)) {
             std::cerr << "❌ Embedding model not found: " << options.embedding_model_path << std::endl;
             return 1;
         }
+        if (!needs_embedding) {
+            options.small_embedding_model_path.clear();
+        }
+        if (!options.small_embedding_model_path.empty() && 
+            !Utils::FileSystem::file_exists(options.small_embedding_model_path)) {
+            std::cerr << "❌ Small embedding model not found: " << options.small_embedding_model_path << std::endl;
+            return 1;
+        }
         
         if (options.verbose) {
             std::cout << "🔧 WhisperDesk Speaker Diarization CLI" << std::endl;
             std::cout << "📁 Audio file: " << options.audio_path << std::endl;
-            std::cout << "🧠 Segmentation model: " << options.segment_model_path << std::endl;
-            std::cout << "🎯 Embedding model: " << options.embedding_model_path << std::endl;
+            std::cout << "🧠 Segmentation model: " 
+                     << (needs_segmentation ? options.segment_model_path : "(not used in uniform mode)") << std::endl;
+            std::cout << "🎯 Embedding model: " 
+                     << (needs_embedding ? options.embedding_model_path : "(not used in fast mode)") << std::endl;
+            if (!options.small_embedding_model_path.empty()) {
+                std::cout << "🪶 Small embedding model: " << options.small_embedding_model_path 
+                         << " (cascade margin " << options.cascade_margin << ")" << std::endl;
+            }
             std::cout << "👥 Max speakers: " << options.max_speakers << std::endl;
             std::cout << "🎚️ Threshold: " << options.threshold << std::endl;
+            std::cout << "🧭 Mode: " << options.mode << " (preset " << options.preset << ")" << std::endl;
+            if (options.autotuned) {
+                std::cout << "⚙️ Tuned settings from " << options.autotune_cache << ": " << options.intra_op_threads 
+                         << " threads, segmentation batch " << options.segmentation_batch_size 
+                         << ", embedding batch " << options.embedding_batch_size << std::endl;
+            }
         }
         
-        // Initialize diarization engine
+        // Fit threads and batches to the container's CPU quota and memory limit
+        ResourceGovernor governor(options.use_cgroup ? ResourceGovernor::detect() : ResourceLimits(),
+                                  options.memory_fraction, options.verbose);
+        governor.apply(options);
+        
+        // Initialize diarization engine; a spool worker warms up before it takes the first job
         DiarizationEngine engine(options.verbose);
-        if (!engine.initialize(options.segment_model_path, options.embedding_model_path)) {
+        StageProfiler profiler;
+        if (options.profile) {
+            AllocationCounter::enable();
+            engine.set_profiler(&profiler);
+        }
+        if (spool) {
+            options.warmup = true;
+        }
+        if (!engine.initialize(options)) {
             std::cerr << "❌ Failed to initialize diarization engine" << std::endl;
             return 1;
         }
+        options.segmentation_provider = engine.segmentation_provider();
+        options.embedding_provider = engine.embedding_provider();
         
-        // Load audio file
+        // Spool worker: models stay loaded while jobs are taken from the spool directory
+        if (spool) {
+            std::signal(SIGINT, [](int) { SpoolWorker::stop(); });
+            std::signal(SIGTERM, [](int) { SpoolWorker::stop(); });
+            
+            SpoolWorker worker(engine, options);
+            return worker.run();
+        }
+        
+        // Load audio file; it is first touched from the segmentation cores, which read it most
+        engine.pin_to_segmentation_cores();
+        engine.begin_profile_stage("audio_load");
         if (options.verbose) {
             std::cout << "📁 Loading audio file..." << std::endl;
         }
         
-        auto audio_data = Utils::Audio::load_audio_file(options.audio_path, options.sample_rate);
+        auto audio_data = Utils::Audio::load_audio_buffer(options.audio_path, options.sample_rate);
         
         if (audio_data.empty()) {
             std::cerr << "❌ Failed to load audio file or file is empty" << std::endl;
@@ -295,11 +1572,78 @@ int main(int argc, char* argv[]) {
         
         if (options.verbose) {
             std::cout << "🎵 Audio loaded: " << audio_data.size() << " samples, " 
-                     << static_cast<float>(audio_data.size()) / options.sample_rate << " seconds" << std::endl;
+                     << static_cast<float>(audio_data.size()) / options.sample_rate << " seconds, "
+                     << audio_data.size() * sizeof(int16_t) / 1024 << " KiB as int16" 
+                     << (audio_data.mapped() ? " (mapped)" : "") << std::endl;
         }
+        governor.apply(options, static_cast<double>(audio_data.size()) / options.sample_rate);
         
-        // Process audio
-        auto segments = engine.process_audio(audio_data, options);
+        // Shard worker: diarize only this shard's range plus overlap
+        ShardResult shard;
+        const bool sharded = options.shard_count > 0;
+        if (sharded) {
+            shard.sample_rate = options.sample_rate;
+            shard.set_range(static_cast<int64_t>(audio_data.size()), options.shard_index, options.shard_count,
+                            static_cast<int64_t>(options.shard_overlap * options.sample_rate));
+            // A slice keeps its whole source alive; owned samples are copied so the rest of the file is freed
+            auto range = audio_data.slice(static_cast<size_t>(shard.range_start), static_cast<size_t>(shard.range_end));
+            audio_data = range.mapped() ? range : AudioBuffer::from_pcm16({range.data(), range.data() + range.size()});
+            
+            if (options.verbose) {
+                std::cout << "🧩 Shard " << options.shard_index << "/" << options.shard_count << ": "
+                         << Utils::Time::samples_to_seconds(shard.range_start, options.sample_rate) << "s - "
+                         << Utils::Time::samples_to_seconds(shard.range_end, options.sample_rate) << "s" << std::endl;
+            }
+        }
+        
+        // Process audio; a signal or a control message cancels it with partial results
+        std::signal(SIGINT, [](int) { JobControl::request_cancel(); });
+        std::signal(SIGTERM, [](int) { JobControl::request_cancel(); });
+        ProgressReporter progress(options.progress_fd);
+        engine.set_progress(&progress);
+        
+        std::vector<AudioSegment> segments;
+        {
+            JobControl control(engine, options.control_fd);
+            segments = engine.process_audio(audio_data, options);
+        }
+        
+        const bool cancelled = engine.get_stats().cancelled;
+        progress.finish(cancelled ? "cancelled" : "done", segments.size());
+        if (options.profile) {
+            profiler.print(std::cerr);  // stdout may carry the JSON result
+        }
+        if (cancelled) {
+            std::cerr << "⏹️ Cancelled, partial results up to " 
+                     << Utils::Time::samples_to_seconds(engine.get_stats().processed_samples, options.sample_rate) 
+                     << "s" << std::endl;
+            
+            // A partial shard would be merged as if complete
+            if (!sharded) {
+                Utils::Json::output_results(segments, options, engine.get_stats());
+            }
+            return 130;
+        }
+        
+        if (sharded) {
+            // A silent shard is a valid result; the merge step needs every shard file
+            for (auto& segment : segments) {
+                segment.start_sample += shard.range_start;
+                segment.end_sample += shard.range_start;
+            }
+            shard.segments = std::move(segments);
+            shard.centroids = engine.get_speaker_centroids();
+            
+            std::string shard_path = ShardResult::file_path(options.shard_dir, options.shard_index);
+            if (!shard.save(shard_path)) {
+                return 1;
+            }
+            if (options.verbose) {
+                std::cout << "✅ Shard written: " << shard_path << " (" << shard.segments.size() << " segments, "
+                         << shard.centroids.size() << " speakers)" << std::endl;
+            }
+            return 0;
+        }
         
         if (segments.empty()) {
             std::cerr << "❌ No segments generated" << std::endl;
@@ -311,12 +1655,14 @@ int main(int argc, char* argv[]) {
             std::cout << "📊 Results: " << segments.size() << " segments" << std::endl;
             
             // Print detailed speaker summary
-            std::map<int, std::vector<std::pair<float, float>>> speaker_segments;
-            std::map<int, float> speaker_durations;
+            std::map<int, std::vector<std::pair<double, double>>> speaker_segments;
+            std::map<int, double> speaker_durations;
             
             for (const auto& segment : segments) {
-                speaker_segments[segment.speaker_id].push_back({segment.start_time, segment.end_time});
-                speaker_durations[segment.speaker_id] += (segment.end_time - segment.start_time);
+                double start = Utils::Time::samples_to_seconds(segment.start_sample, options.sample_rate);
+                double end = Utils::Time::samples_to_seconds(segment.end_sample, options.sample_rate);
+                speaker_segments[segment.speaker_id].push_back({start, end});
+                speaker_durations[segment.speaker_id] += (end - start);
             }
             
             std::cout << "👥 Detected " << speaker_segments.size() << " speakers:" << std::endl;
@@ -335,7 +1681,12 @@ int main(int argc, char* argv[]) {
         }
         
         // Output results
-        Utils::Json::output_results(segments, options);
+        Utils::Json::output_results(segments, options, engine.get_stats());
+        
+        // Allocation regression check: the results stand, but the run fails
+        if (!options.allocation_budgets.empty() && !profiler.check_budgets(options.allocation_budgets, std::cerr)) {
+            return 1;
+        }
         
         return 0;
         
@@ -0,0 +1,214 @@
+// src/native/diarization/diarize-state.cpp
+#include "diarize-state.h"
+#include "binary-io.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+
+constexpr char kStateMagic[4] = {'W', 'D', 'S', 'T'};
+constexpr uint32_t kStateVersion = 3;
+
+uint64_t hash_samples(const int16_t* samples, size_t count, uint64_t hash) {
+    for (size_t i = 0; i < count; i++) {
+        hash ^= static_cast<uint16_t>(samples[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+using namespace BinaryIO;
+
+uint64_t DiarizeState::hash_prefix(const AudioBuffer& audio, size_t samples) {
+    samples = std::min(samples, audio.size());
+    const size_t head = std::min(samples, kCheckSamples);
+    const size_t tail_begin = std::max(head, samples > kCheckSamples ? samples - kCheckSamples : 0);
+    
+    uint64_t hash = 1469598103934665603ull;
+    hash = hash_samples(audio.data(), head, hash);
+    hash = hash_samples(audio.data() + tail_begin, samples - tail_begin, hash);
+    hash ^= static_cast<uint64_t>(samples);
+    return hash * 1099511628211ull;
+}
+
+bool DiarizeState::save(const std::string& path) const {
+    // Write next to the target and rename, so readers never see a half-written state
+    const std::string temp_path = path + ".tmp";
+    
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "❌ Cannot write state file: " << temp_path << std::endl;
+            return false;
+        }
+        
+        out.write(kStateMagic, sizeof(kStateMagic));
+        write_value(out, kStateVersion);
+        write_string(out, mode);
+        write_string(out, embedding_model);
+        write_value(out, embedding_duration);
+        write_value(out, sample_rate);
+        write_value(out, window_size);
+        write_value(out, hop_size);
+        write_value(out, audio_samples);
+        write_value(out, prefix_hash);
+        
+        write_value(out, static_cast<uint64_t>(windows.size()));
+        for (const auto& window : windows) {
+            write_value(out, window.start_sample);
+            write_value(out, static_cast<uint64_t>(window.num_frames));
+            write_value(out, static_cast<uint64_t>(window.num_speakers));
+            write_floats(out, window.activity);
+        }
+        
+        write_value(out, static_cast<uint64_t>(track_embeddings.size()));
+        for (const auto& track : track_embeddings) {
+            write_value(out, static_cast<int32_t>(track.track_id));
+            write_value(out, track.first_frame);
+            write_value(out, track.window_count);
+            write_floats(out, track.embedding);
+        }
+        
+        out.flush();
+        if (!out) {
+            std::cerr << "❌ Failed to write state file: " << temp_path << std::endl;
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+    
+    if (!replace_file(temp_path, path)) {
+        std::cerr << "❌ Failed to replace state file: " << path << std::endl;
+        return false;
+    }
+    
+    return true;
+}
+
+bool DiarizeState::load(const std::string& path) {
+    *this = DiarizeState();
+    
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    
+    DiarizeState state;
+    char magic[sizeof(kStateMagic)];
+    uint32_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kStateMagic, sizeof(magic)) != 0 ||
+        !read_value(in, version) || version != kStateVersion) {
+        std::cerr << "⚠️ Not a compatible state file: " << path << std::endl;
+        return false;
+    }
+    
+    uint64_t window_count = 0;
+    bool ok = read_string(in, state.mode) &&
+              read_string(in, state.embedding_model) &&
+              read_value(in, state.embedding_duration) &&
+              read_value(in, state.sample_rate) &&
+              read_value(in, state.window_size) &&
+              read_value(in, state.hop_size) &&
+              read_value(in, state.audio_samples) &&
+              read_value(in, state.prefix_hash) &&
+              read_value(in, window_count);
+    
+    for (uint64_t i = 0; ok && i < window_count; i++) {
+        WindowActivity window;
+        uint64_t frames = 0;
+        uint64_t speakers = 0;
+        ok = read_value(in, window.start_sample) &&
+             read_value(in, frames) &&
+             read_value(in, speakers) &&
+             read_floats(in, window.activity) &&
+             window.activity.size() == frames * speakers;
+        window.num_frames = static_cast<size_t>(frames);
+        window.num_speakers = static_cast<size_t>(speakers);
+        state.windows.push_back(std::move(window));
+    }
+    
+    uint64_t track_count = 0;
+    ok = ok && read_value(in, track_count);
+    for (uint64_t i = 0; ok && i < track_count; i++) {
+        TrackEmbedding track;
+        int32_t track_id = -1;
+        ok = read_value(in, track_id) &&
+             read_value(in, track.first_frame) &&
+             read_value(in, track.window_count) &&
+             read_floats(in, track.embedding);
+        track.track_id = track_id;
+        state.track_embeddings.push_back(std::move(track));
+    }
+    
+    if (!ok) {
+        std::cerr << "⚠️ Truncated or corrupt state file: " << path << std::endl;
+        return false;
+    }
+    
+    *this = std::move(state);
+    return true;
+}
+
+bool DiarizeState::applies_to(const AudioBuffer& audio, const DiarizeState& settings, bool exact, std::string& reason) const {
+    if (mode != settings.mode || embedding_model != settings.embedding_model ||
+        embedding_duration != settings.embedding_duration || sample_rate != settings.sample_rate ||
+        window_size != settings.window_size || hop_size != settings.hop_size) {
+        reason = "settings changed";
+        return false;
+    }
+    
+    if (audio_samples > static_cast<int64_t>(audio.size())) {
+        reason = "audio is shorter than the cached prefix";
+        return false;
+    }
+    
+    if (exact && audio_samples != static_cast<int64_t>(audio.size())) {
+        reason = "audio length differs";
+        return false;
+    }
+    
+    if (hash_prefix(audio, static_cast<size_t>(audio_samples)) != prefix_hash) {
+        reason = "audio prefix differs";
+        return false;
+    }
+    
+    return true;
+}
+
+const std::vector<float>* DiarizeState::find_embedding(int track_id, int64_t first_frame, uint64_t window_count) const {
+    for (const auto& track : track_embeddings) {
+        if (track.track_id == track_id && track.first_frame == first_frame && track.window_count == window_count) {
+            return &track.embedding;
+        }
+    }
+    return nullptr;
+}
+
+CheckpointSchedule::CheckpointSchedule(double interval_seconds, double overhead_budget)
+    : interval_seconds_(interval_seconds),
+      overhead_budget_(overhead_budget),
+      last_write_(Clock::now()),
+      write_count_(0),
+      write_seconds_(0.0) {
+}
+
+bool CheckpointSchedule::due() const {
+    return std::chrono::duration<double>(Clock::now() - last_write_).count() >= interval_seconds_;
+}
+
+void CheckpointSchedule::record_write(Clock::time_point started) {
+    last_write_ = Clock::now();
+    double seconds = std::chrono::duration<double>(last_write_ - started).count();
+    write_seconds_ += seconds;
+    write_count_++;
+    
+    // Keep each write under the overhead budget of the interval that follows it
+    if (seconds > overhead_budget_ * interval_seconds_) {
+        interval_seconds_ = seconds / overhead_budget_;
+    }
+}
@@ -0,0 +1,80 @@
+// src/native/diarization/embedding-cascade.cpp
+#include "embedding-cascade.h"
+#include <iostream>
+#include <algorithm>
+
+EmbeddingCascade::EmbeddingCascade(SpeakerEmbedder& small, SpeakerEmbedder& large, float margin, bool verbose)
+    : small_(small),
+      large_(large),
+      margin_(margin),
+      verbose_(verbose),
+      assigned_count_(0),
+      escalated_count_(0) {
+}
+
+void EmbeddingCascade::reset() {
+    small_.reset_speakers();
+    large_.reset_speakers();
+    anchors_.clear();
+    assigned_count_ = 0;
+    escalated_count_ = 0;
+}
+
+float EmbeddingCascade::decision_margin(const SpeakerMatch& match, float threshold) {
+    if (match.speaker_id < 0) {
+        return 1.0f;  // First speaker: nothing to confuse it with
+    }
+    
+    // Joining the best speaker competes with the runner-up and with opening a new speaker
+    if (match.similarity > threshold) {
+        return match.similarity - std::max(match.runner_up, threshold);
+    }
+    return threshold - match.similarity;
+}
+
+int EmbeddingCascade::assign(const std::vector<float>& small_embedding, const CropSource& crops,
+                             float threshold, int max_speakers) {
+    assigned_count_++;
+    
+    SpeakerMatch match = small_.match_speaker(small_embedding);
+    const int speaker_count = static_cast<int>(small_.get_speaker_count());
+    
+    if (decision_margin(match, threshold) >= margin_) {
+        int speaker_id = small_.find_or_create_speaker(small_embedding, threshold, max_speakers);
+        if (speaker_id >= speaker_count) {
+            anchors_.push_back(crops);
+        }
+        return speaker_id;
+    }
+    
+    // Ambiguous: decide with the large model against large-model centroids
+    escalated_count_++;
+    anchor_large_speakers();
+    
+    std::vector<float> large_embedding = large_.extract_mean_embedding(crops(large_.get_target_length()));
+    SpeakerMatch large_match = large_.match_speaker(large_embedding);
+    
+    int speaker_id = large_match.speaker_id;
+    if (speaker_id < 0 || (large_match.similarity <= threshold && speaker_count < max_speakers)) {
+        speaker_id = speaker_count;
+        anchors_.push_back(crops);
+    }
+    
+    if (verbose_) {
+        std::cout << "🔁 Escalated to large model: small margin " << decision_margin(match, threshold)
+                 << ", large similarity " << large_match.similarity << " -> speaker " << speaker_id << std::endl;
+    }
+    
+    small_.add_to_speaker(speaker_id, small_embedding);
+    large_.add_to_speaker(speaker_id, large_embedding);
+    return speaker_id;
+}
+
+void EmbeddingCascade::anchor_large_speakers() {
+    for (size_t i = 0; i < anchors_.size(); i++) {
+        int speaker_id = static_cast<int>(i);
+        if (!large_.has_speaker(speaker_id)) {
+            large_.add_to_speaker(speaker_id, large_.extract_mean_embedding(anchors_[i](large_.get_target_length())));
+        }
+    }
+}
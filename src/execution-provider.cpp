@@ -0,0 +1,136 @@
+// src/native/diarization/execution-provider.cpp
+#include "execution-provider.h"
+#include "utils.h"
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// ONNX Runtime's name of each provider, as listed by Ort::GetAvailableProviders()
+std::string ort_name(const std::string& name) {
+    if (name == "xnnpack") return "XnnpackExecutionProvider";
+    if (name == "dnnl") return "DnnlExecutionProvider";
+    return "CPUExecutionProvider";
+}
+
+std::unique_ptr<Ort::Session> load(Ort::Env& env, const std::string& model, const Ort::SessionOptions& options) {
+    const std::string model_path = ExecutionProvider::model_file(model);
+#ifdef _WIN32
+    auto wmodel_path = string_to_wstring(model_path);
+    return std::make_unique<Ort::Session>(env, wmodel_path.c_str(), options);
+#else
+    return std::make_unique<Ort::Session>(env, model_path.c_str(), options);
+#endif
+}
+
+// Session options with the provider registered ahead of the implicit default provider
+Ort::SessionOptions with_provider(const Ort::SessionOptions& base, const std::string& provider,
+                                  int threads, bool cpu_fallback) {
+    Ort::SessionOptions options = base.Clone();
+    if (!cpu_fallback) {
+        options.AddConfigEntry("session.disable_cpu_ep_fallback", "1");
+    }
+    
+    if (provider == "xnnpack") {
+        // XNNPACK brings its own pool; idle ORT pool threads must not spin against it
+        options.AddConfigEntry("session.intra_op.allow_spinning", "0");
+        options.AppendExecutionProvider("XNNPACK", {{"intra_op_num_threads", std::to_string(threads)}});
+    } else if (provider == "dnnl") {
+        const OrtApi& api = Ort::GetApi();
+        OrtDnnlProviderOptions* dnnl = nullptr;
+        Ort::ThrowOnError(api.CreateDnnlProviderOptions(&dnnl));
+        OrtStatus* status = api.SessionOptionsAppendExecutionProvider_Dnnl(options, dnnl);
+        api.ReleaseDnnlProviderOptions(dnnl);
+        Ort::ThrowOnError(status);
+    }
+    return options;
+}
+
+} // namespace
+
+namespace ExecutionProvider {
+
+const std::vector<std::string>& names() {
+    static const std::vector<std::string> providers = {"cpu", "xnnpack", "dnnl"};
+    return providers;
+}
+
+std::string model_file(const std::string& model_path) {
+    const std::string extension = ".onnx";
+    if (model_path.size() > extension.size() && 
+        model_path.compare(model_path.size() - extension.size(), extension.size(), extension) == 0) {
+        std::string ort_path = model_path.substr(0, model_path.size() - extension.size()) + ".ort";
+#ifdef DIARIZATION_MINIMAL_ORT
+        if (Utils::FileSystem::file_exists(ort_path)) {
+            return ort_path;
+        }
+        throw std::runtime_error("this build only loads ORT format models and " + ort_path + 
+                                 " does not exist (see scripts/build-minimal-ort.sh)");
+#else
+        // A .ort converted before the .onnx was last updated is stale and must not shadow it
+        std::error_code ort_error;
+        std::error_code onnx_error;
+        const auto ort_time = fs::last_write_time(ort_path, ort_error);
+        const auto onnx_time = fs::last_write_time(model_path, onnx_error);
+        if (!ort_error && (onnx_error || ort_time >= onnx_time)) {
+            return ort_path;
+        }
+#endif
+    }
+    return model_path;
+}
+
+bool is_available(const std::string& name) {
+    if (name == "cpu") {
+        return true;
+    }
+#ifdef DIARIZATION_MINIMAL_ORT
+    return false;  // Only the default provider's reduced kernels are compiled in
+#else
+    try {
+        auto available = Ort::GetAvailableProviders();
+        return std::find(available.begin(), available.end(), ort_name(name)) != available.end();
+    } catch (const std::exception&) {
+        return false;
+    }
+#endif
+}
+
+std::unique_ptr<Ort::Session> create_session(Ort::Env& env, const std::string& model_path,
+                                             const Ort::SessionOptions& base, const std::string& provider,
+                                             int threads, std::string& used, bool verbose) {
+    if (provider != "cpu") {
+        if (!is_available(provider)) {
+            std::cerr << "⚠️ Provider " << provider << " is not in this ONNX Runtime build, using cpu" << std::endl;
+        } else {
+            try {
+                auto session = load(env, model_path, with_provider(base, provider, threads, false));
+                used = provider;
+                return session;
+            } catch (const std::exception&) {
+                // Some nodes are unsupported; retry with those on the default provider
+            }
+            try {
+                auto session = load(env, model_path, with_provider(base, provider, threads, true));
+                used = provider + "+cpu";
+                if (verbose) {
+                    std::cout << "ℹ️ " << provider << " does not support every node of " << model_path
+                             << ", the rest runs on cpu" << std::endl;
+                }
+                return session;
+            } catch (const std::exception& e) {
+                std::cerr << "⚠️ Provider " << provider << " failed (" << e.what() << "), using cpu" << std::endl;
+            }
+        }
+    }
+    
+    auto session = load(env, model_path, base);
+    used = "cpu";
+    return session;
+}
+
+} // namespace ExecutionProvider
@@ -0,0 +1,141 @@
+// src/native/diarization/job-control.cpp
+#include "job-control.h"
+#include "diarize-cli.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <poll.h>
+#endif
+
+namespace {
+
+constexpr double kMinEmitInterval = 0.5;   // Seconds between progress events of one stage
+constexpr double kMinEmitStep = 0.05;      // ...unless progress moved at least this much
+constexpr int kWatchIntervalMs = 50;       // Latency of cancellation requests
+
+} // namespace
+
+std::atomic<bool> JobControl::cancel_requested_(false);
+
+ProgressReporter::ProgressReporter(int fd)
+    : fd_(fd),
+      stage_start_(Clock::now()),
+      last_emit_(Clock::now()),
+      last_fraction_(0.0) {
+}
+
+void ProgressReporter::emit(const std::string& line) {
+    if (fd_ < 0) return;
+    
+    const std::string data = line + "\n";
+    size_t written = 0;
+    while (written < data.size()) {
+#ifdef _WIN32
+        int n = _write(fd_, data.data() + written, static_cast<unsigned int>(data.size() - written));
+#else
+        ssize_t n = write(fd_, data.data() + written, data.size() - written);
+#endif
+        if (n <= 0) {
+            fd_ = -1;  // Reader went away: stop reporting rather than fail the job
+            return;
+        }
+        written += static_cast<size_t>(n);
+    }
+}
+
+void ProgressReporter::begin_stage(const std::string& stage) {
+    if (fd_ < 0) return;
+    
+    stage_ = stage;
+    stage_start_ = Clock::now();
+    last_emit_ = stage_start_;
+    last_fraction_ = 0.0;
+    emit("{\"event\":\"stage\",\"stage\":\"" + stage_ + "\"}");
+}
+
+void ProgressReporter::update(double fraction) {
+    if (fd_ < 0) return;
+    
+    fraction = std::max(0.0, std::min(1.0, fraction));
+    const auto now = Clock::now();
+    const double since_emit = std::chrono::duration<double>(now - last_emit_).count();
+    if (since_emit < kMinEmitInterval && fraction - last_fraction_ < kMinEmitStep && fraction < 1.0) {
+        return;
+    }
+    
+    const double elapsed = std::chrono::duration<double>(now - stage_start_).count();
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(3)
+         << "{\"event\":\"progress\",\"stage\":\"" << stage_ << "\",\"fraction\":" << fraction
+         << ",\"elapsed_seconds\":" << std::setprecision(1) << elapsed;
+    if (fraction > 0.0) {
+        line << ",\"eta_seconds\":" << elapsed / fraction * (1.0 - fraction);
+    }
+    line << "}";
+    
+    emit(line.str());
+    last_emit_ = now;
+    last_fraction_ = fraction;
+}
+
+void ProgressReporter::finish(const std::string& status, size_t segments) {
+    emit("{\"event\":\"" + status + "\",\"segments\":" + std::to_string(segments) + "}");
+}
+
+JobControl::JobControl(DiarizationEngine& engine, int control_fd)
+    : engine_(engine),
+      control_fd_(control_fd),
+      stop_(false) {
+    watcher_ = std::thread(&JobControl::watch, this);
+}
+
+JobControl::~JobControl() {
+    stop_ = true;
+    if (watcher_.joinable()) {
+        watcher_.join();
+    }
+}
+
+void JobControl::watch() {
+    std::string pending;
+    
+    while (!stop_) {
+        if (cancel_requested_) {
+            engine_.cancel();
+            return;
+        }
+
+#ifndef _WIN32
+        if (control_fd_ >= 0) {
+            pollfd pfd = {control_fd_, POLLIN, 0};
+            if (poll(&pfd, 1, kWatchIntervalMs) > 0) {
+                char buffer[256];
+                ssize_t n = read(control_fd_, buffer, sizeof(buffer));
+                if (n <= 0) {
+                    control_fd_ = -1;  // Controller closed the fd; signals still work
+                    continue;
+                }
+                
+                // Control messages are lines; "cancel" is the only one so far
+                pending.append(buffer, static_cast<size_t>(n));
+                size_t newline;
+                while ((newline = pending.find('\n')) != std::string::npos) {
+                    std::string message = pending.substr(0, newline);
+                    pending.erase(0, newline + 1);
+                    if (!message.empty() && message.back() == '\r') message.pop_back();
+                    if (message == "cancel") {
+                        request_cancel();
+                    }
+                }
+            }
+            continue;
+        }
+#endif
+        std::this_thread::sleep_for(std::chrono::milliseconds(kWatchIntervalMs));
+    }
+}
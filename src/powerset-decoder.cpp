@@ -0,0 +1,115 @@
+// src/native/diarization/powerset-decoder.cpp
+#include "powerset-decoder.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Enumerate all k-combinations of [0, n) in lexicographic order (itertools.combinations)
+void append_combinations(size_t n, size_t k, std::vector<std::vector<size_t>>& out) {
+    std::vector<size_t> combo(k);
+    for (size_t i = 0; i < k; i++) {
+        combo[i] = i;
+    }
+
+    while (true) {
+        out.push_back(combo);
+
+        // Find rightmost element that can still be incremented
+        size_t i = k;
+        while (i > 0 && combo[i - 1] == n - k + (i - 1)) {
+            i--;
+        }
+        if (i == 0) {
+            return;
+        }
+
+        combo[i - 1]++;
+        for (size_t j = i; j < k; j++) {
+            combo[j] = combo[j - 1] + 1;
+        }
+    }
+}
+
+// Output frames of segmentation-3.0 for a 51200-sample (3.2 s) window
+constexpr size_t kSegmentation3Frames = 186;
+
+// segmentation-3.0 classes {}, {0}, {1}, {2}, {0,1}, {0,2}, {1,2}; Frames = 0 reads the count at run time
+template <size_t Frames>
+void decode_segmentation3(const float* logits, size_t num_frames, float* activity) {
+    constexpr size_t kClasses = 7;
+    constexpr size_t kSpeakers = 3;
+    const size_t frames = Frames ? Frames : num_frames;
+
+    for (size_t t = 0; t < frames; t++) {
+        const float* frame_logits = logits + t * kClasses;
+        float* frame_activity = activity + t * kSpeakers;
+
+        float max_logit = frame_logits[0];
+        for (size_t c = 1; c < kClasses; c++) {
+            max_logit = std::max(max_logit, frame_logits[c]);
+        }
+        float prob[kClasses];
+        float sum_exp = 0.0f;
+        for (size_t c = 0; c < kClasses; c++) {
+            prob[c] = std::exp(frame_logits[c] - max_logit);
+            sum_exp += prob[c];
+        }
+
+        const float scale = 1.0f / sum_exp;
+        frame_activity[0] = std::min(1.0f, (prob[1] + prob[4] + prob[5]) * scale);
+        frame_activity[1] = std::min(1.0f, (prob[2] + prob[4] + prob[6]) * scale);
+        frame_activity[2] = std::min(1.0f, (prob[3] + prob[5] + prob[6]) * scale);
+    }
+}
+
+} // namespace
+
+PowersetDecoder::PowersetDecoder(size_t num_speakers, size_t max_simultaneous)
+    : num_speakers_(num_speakers),
+      max_simultaneous_(std::min(max_simultaneous, num_speakers)),
+      segmentation3_(num_speakers == 3 && max_simultaneous_ == 2) {
+
+    // Same class order as pyannote.audio Powerset: by set size, then lexicographic
+    class_speakers_.push_back({});
+    for (size_t k = 1; k <= max_simultaneous_; k++) {
+        append_combinations(num_speakers_, k, class_speakers_);
+    }
+}
+
+void PowersetDecoder::decode(const float* logits, size_t num_frames, float* activity) const {
+    if (segmentation3_) {
+        if (num_frames == kSegmentation3Frames) {
+            decode_segmentation3<kSegmentation3Frames>(logits, num_frames, activity);
+        } else {
+            decode_segmentation3<0>(logits, num_frames, activity);
+        }
+        return;
+    }
+
+    const size_t classes = num_classes();
+
+    for (size_t t = 0; t < num_frames; t++) {
+        const float* frame_logits = logits + t * classes;
+        float* frame_activity = activity + t * num_speakers_;
+
+        // Softmax over powerset classes
+        float max_logit = *std::max_element(frame_logits, frame_logits + classes);
+        float sum_exp = 0.0f;
+        for (size_t c = 0; c < classes; c++) {
+            sum_exp += std::exp(frame_logits[c] - max_logit);
+        }
+
+        std::fill(frame_activity, frame_activity + num_speakers_, 0.0f);
+        for (size_t c = 0; c < classes; c++) {
+            float prob = std::exp(frame_logits[c] - max_logit) / sum_exp;
+            for (size_t speaker : class_speakers_[c]) {
+                frame_activity[speaker] += prob;
+            }
+        }
+
+        for (size_t s = 0; s < num_speakers_; s++) {
+            frame_activity[s] = std::min(1.0f, frame_activity[s]);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+// src/native/diarization/presets.cpp
+#include "presets.h"
+
+namespace {
+
+// balanced keeps the historical defaults. fast trades window overlap, embedding context and
+// short segments for throughput; accurate goes the other way. scripts/benchmark-presets.sh
+// measures RTF and DER of each preset on a reference corpus.
+const Preset kPresets[] = {
+    // name        threads window  hop   embed  batch  min seg  fallback
+    {"fast",       4,      3.2f,   2.4f, 2.0f,  64,    3.0f,    30.0f},
+    {"balanced",   4,      3.2f,   1.6f, 3.0f,  32,    2.0f,    25.0f},
+    {"accurate",   4,      3.2f,   0.8f, 4.0f,  16,    1.0f,    15.0f},
+};
+
+} // namespace
+
+namespace Presets {
+
+const Preset* find(const std::string& name) {
+    for (const auto& preset : kPresets) {
+        if (name == preset.name) {
+            return &preset;
+        }
+    }
+    return nullptr;
+}
+
+bool apply(const std::string& name, DiarizeOptions& options) {
+    const Preset* preset = find(name);
+    if (!preset) {
+        return false;
+    }
+    
+    options.preset = preset->name;
+    options.intra_op_threads = preset->intra_op_threads;
+    options.segment_window = preset->segment_window;
+    options.segment_hop = preset->segment_hop;
+    options.embedding_duration = preset->embedding_duration;
+    options.embedding_batch_size = preset->embedding_batch_size;
+    options.min_segment_duration = preset->min_segment_duration;
+    options.fallback_segment_duration = preset->fallback_segment_duration;
+    return true;
+}
+
+std::string names() {
+    std::string result;
+    for (const auto& preset : kPresets) {
+        if (!result.empty()) result += "|";
+        result += preset.name;
+    }
+    return result;
+}
+
+} // namespace Presets
@@ -0,0 +1,160 @@
+// src/native/diarization/resource-governor.cpp
+#include "resource-governor.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+const char* kCgroupRoot = "/sys/fs/cgroup";
+
+// Working set per input sample of one batch item: ONNX Runtime activations of the
+// segmentation (SincNet + LSTM) and embedding (ResNet on fbank) models are far larger
+// than the float audio itself. Deliberately conservative estimates.
+constexpr int64_t kSegmentationBytesPerSample = 4 * 48;
+constexpr int64_t kEmbeddingBytesPerSample = 4 * 96;
+constexpr double kBatchBudgetShare = 0.25;   // Share of the budget one model batch may use
+constexpr int64_t kMemoryOverhead = 64 << 20;  // Models, arenas and everything not modelled above
+
+std::string read_line(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+// This process's cgroup v2 path from /proc/self/cgroup ("0::/kubepods/...")
+std::string own_cgroup() {
+    std::ifstream file("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.rfind("0::", 0) == 0) {
+            return line.substr(3);
+        }
+    }
+    return "";
+}
+
+} // namespace
+
+ResourceGovernor::ResourceGovernor(const ResourceLimits& limits, float memory_fraction, bool verbose)
+    : limits_(limits),
+      memory_fraction_(std::max(0.05f, std::min(1.0f, memory_fraction))),
+      verbose_(verbose) {
+}
+
+ResourceLimits ResourceGovernor::detect() {
+    ResourceLimits limits;
+#ifdef __linux__
+    std::string cgroup = own_cgroup();
+    if (cgroup.empty() || read_line(std::string(kCgroupRoot) + "/cgroup.controllers").empty()) {
+        return limits;  // cgroup v1 or no cgroup filesystem
+    }
+    limits.cgroup = cgroup;
+    
+    // Walk from the process's cgroup up to the root; every level's limit applies
+    std::string path = cgroup;
+    bool leaf = true;
+    while (true) {
+        const std::string dir = std::string(kCgroupRoot) + (path == "/" ? "" : path);
+        
+        std::istringstream cpu(read_line(dir + "/cpu.max"));
+        std::string quota;
+        double period = 0.0;
+        if (cpu >> quota >> period && quota != "max" && period > 0.0) {
+            double cpus = std::strtod(quota.c_str(), nullptr) / period;
+            if (cpus > 0.0) {
+                limits.cpus = limits.cpus > 0.0 ? std::min(limits.cpus, cpus) : cpus;
+            }
+        }
+        
+        std::string memory = read_line(dir + "/memory.max");
+        if (!memory.empty() && memory != "max") {
+            int64_t bytes = std::strtoll(memory.c_str(), nullptr, 10);
+            if (bytes > 0) {
+                limits.memory_bytes = limits.memory_bytes > 0 ? std::min(limits.memory_bytes, bytes) : bytes;
+            }
+        }
+        if (leaf) {
+            std::string current = read_line(dir + "/memory.current");
+            if (!current.empty()) {
+                limits.memory_used = std::strtoll(current.c_str(), nullptr, 10);
+            }
+            leaf = false;
+        }
+        
+        if (path == "/" || path.empty()) break;
+        auto slash = path.find_last_of('/');
+        path = slash == 0 ? "/" : path.substr(0, slash);
+    }
+#endif
+    return limits;
+}
+
+int64_t ResourceGovernor::memory_budget() const {
+    if (limits_.memory_bytes <= 0) {
+        return 0;
+    }
+    int64_t budget = static_cast<int64_t>(limits_.memory_bytes * static_cast<double>(memory_fraction_)) 
+                     - limits_.memory_used - kMemoryOverhead;
+    return std::max<int64_t>(budget, 1);
+}
+
+int ResourceGovernor::max_items(int64_t bytes_per_item, double budget_share, int current) const {
+    const int64_t budget = memory_budget();
+    if (budget == 0 || bytes_per_item <= 0) {
+        return current;
+    }
+    int64_t fit = static_cast<int64_t>(budget * budget_share) / bytes_per_item;
+    return static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(current, fit)));
+}
+
+void ResourceGovernor::apply(DiarizeOptions& options, double audio_seconds) const {
+    if (!limits_.limited()) {
+        return;
+    }
+    
+    options.cpu_limit = limits_.cpus;
+    options.memory_limit = limits_.memory_bytes;
+    
+    // Models run one after the other, so each pool may use the whole quota, but not more
+    if (limits_.cpus > 0.0) {
+        const int cpus = std::max(1, static_cast<int>(std::floor(limits_.cpus)));
+        if (options.intra_op_threads > cpus && verbose_) {
+            std::cout << "📦 CPU quota " << limits_.cpus << " cores: " << options.intra_op_threads 
+                     << " -> " << cpus << " intra-op threads" << std::endl;
+        }
+        options.intra_op_threads = std::min(options.intra_op_threads, cpus);
+        options.thread_spinning = false;  // Spinning threads burn the quota and cause throttling
+    }
+    
+    if (limits_.memory_bytes > 0) {
+        const int64_t window = static_cast<int64_t>(options.segment_window * options.sample_rate);
+        const int64_t segment = static_cast<int64_t>(options.embedding_duration * options.sample_rate);
+        
+        const int segmentation_batch = max_items(window * kSegmentationBytesPerSample, kBatchBudgetShare,
+                                                 options.segmentation_batch_size);
+        const int embedding_batch = max_items(segment * kEmbeddingBytesPerSample, kBatchBudgetShare,
+                                              options.embedding_batch_size);
+        if (verbose_ && (segmentation_batch < options.segmentation_batch_size || 
+                         embedding_batch < options.embedding_batch_size)) {
+            std::cout << "📦 Memory limit " << (limits_.memory_bytes >> 20) << " MiB: batches " 
+                     << options.segmentation_batch_size << "/" << options.embedding_batch_size << " -> "
+                     << segmentation_batch << "/" << embedding_batch << std::endl;
+        }
+        options.segmentation_batch_size = segmentation_batch;
+        options.embedding_batch_size = embedding_batch;
+        
+        // The audio is held in memory as int16, plus float copies of its segments in change point mode;
+        // warn before the kernel's OOM killer does
+        const int64_t bytes_per_sample = options.mode == "changepoint" ? 6 : 2;
+        const int64_t audio_bytes = static_cast<int64_t>(audio_seconds * options.sample_rate) * bytes_per_sample;
+        if (audio_bytes > memory_budget()) {
+            std::cerr << "⚠️ Audio needs " << (audio_bytes >> 20) << " MiB, over the memory budget of " 
+                     << (memory_budget() >> 20) << " MiB; consider --shard" << std::endl;
+        }
+    }
+}
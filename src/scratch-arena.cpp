@@ -0,0 +1,56 @@
+// src/native/diarization/scratch-arena.cpp
+#include "scratch-arena.h"
+#include <algorithm>
+#include <cstdint>
+
+ScratchArena::ScratchArena(size_t min_block_size)
+    : min_block_size_(min_block_size),
+      in_use_(0),
+      peak_(0),
+      block_allocations_(0) {
+}
+
+void ScratchArena::add_block(size_t size) {
+    Block block;
+    block.memory.reset(new unsigned char[size + kAlignment]);
+    const auto address = reinterpret_cast<uintptr_t>(block.memory.get());
+    block.begin = block.memory.get() + (kAlignment - address % kAlignment) % kAlignment;
+    block.size = size;
+    blocks_.push_back(std::move(block));
+    block_allocations_++;
+}
+
+void* ScratchArena::allocate_bytes(size_t bytes) {
+    const size_t rounded = (std::max<size_t>(bytes, 1) + kAlignment - 1) / kAlignment * kAlignment;
+    
+    if (blocks_.empty() || blocks_.back().size - blocks_.back().used < rounded) {
+        add_block(std::max(min_block_size_, rounded));
+    }
+    
+    Block& block = blocks_.back();
+    void* buffer = block.begin + block.used;
+    block.used += rounded;
+    in_use_ += rounded;
+    peak_ = std::max(peak_, in_use_);
+    return buffer;
+}
+
+void ScratchArena::reset() {
+    // One block large enough for the busiest pass so far
+    if (blocks_.size() > 1) {
+        blocks_.clear();
+        add_block(std::max(min_block_size_, peak_));
+    }
+    for (auto& block : blocks_) {
+        block.used = 0;
+    }
+    in_use_ = 0;
+}
+
+size_t ScratchArena::capacity() const {
+    size_t total = 0;
+    for (const auto& block : blocks_) {
+        total += block.size;
+    }
+    return total;
+}
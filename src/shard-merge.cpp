@@ -0,0 +1,368 @@
+// src/native/diarization/shard-merge.cpp
+#include "shard-merge.h"
+#include "binary-io.h"
+#include "utils.h"
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <cstring>
+
+namespace {
+
+constexpr char kShardMagic[4] = {'W', 'D', 'S', 'H'};
+constexpr uint32_t kShardVersion = 1;
+constexpr float kLinkThreshold = 0.5f;   // Minimum combined score to link across an overlap
+constexpr int32_t kMaxLocalSpeakers = 1024;  // Speaker IDs beyond this are not from a diarization
+
+// Length of [start, end) inside [region_start, region_end)
+int64_t clipped_length(int64_t start, int64_t end, int64_t region_start, int64_t region_end) {
+    return std::max<int64_t>(0, std::min(end, region_end) - std::max(start, region_start));
+}
+
+} // namespace
+
+using namespace BinaryIO;
+
+void ShardResult::set_range(int64_t total_samples, int index, int count, int64_t overlap) {
+    shard_index = index;
+    shard_count = count;
+    core_start = total_samples * index / count;
+    core_end = total_samples * (index + 1) / count;
+    range_start = std::max<int64_t>(0, core_start - overlap);
+    range_end = std::min(total_samples, core_end + overlap);
+}
+
+size_t ShardResult::local_speaker_count() const {
+    size_t count = centroids.size();
+    for (const auto& segment : segments) {
+        count = std::max(count, static_cast<size_t>(segment.speaker_id + 1));
+    }
+    return count;
+}
+
+std::string ShardResult::file_path(const std::string& shard_dir, int index) {
+    return shard_dir + "/shard-" + std::to_string(index) + ".wdshard";
+}
+
+bool ShardResult::save(const std::string& path) const {
+    const std::string temp_path = path + ".tmp";
+    
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "❌ Cannot write shard file: " << temp_path << std::endl;
+            return false;
+        }
+        
+        out.write(kShardMagic, sizeof(kShardMagic));
+        write_value(out, kShardVersion);
+        write_value(out, shard_index);
+        write_value(out, shard_count);
+        write_value(out, sample_rate);
+        write_value(out, core_start);
+        write_value(out, core_end);
+        write_value(out, range_start);
+        write_value(out, range_end);
+        
+        write_value(out, static_cast<uint64_t>(segments.size()));
+        for (const auto& segment : segments) {
+            write_value(out, static_cast<int64_t>(segment.start_sample));
+            write_value(out, static_cast<int64_t>(segment.end_sample));
+            write_value(out, static_cast<int32_t>(segment.speaker_id));
+            write_value(out, segment.confidence);
+        }
+        
+        write_value(out, static_cast<uint64_t>(centroids.size()));
+        for (const auto& centroid : centroids) {
+            write_floats(out, centroid);
+        }
+        
+        out.flush();
+        if (!out) {
+            std::cerr << "❌ Failed to write shard file: " << temp_path << std::endl;
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+    
+    if (!replace_file(temp_path, path)) {
+        std::cerr << "❌ Failed to replace shard file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ShardResult::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "❌ Cannot open shard file: " << path << std::endl;
+        return false;
+    }
+    
+    ShardResult shard;
+    char magic[sizeof(kShardMagic)];
+    uint32_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kShardMagic, sizeof(magic)) != 0 ||
+        !read_value(in, version) || version != kShardVersion) {
+        std::cerr << "❌ Not a compatible shard file: " << path << std::endl;
+        return false;
+    }
+    
+    uint64_t segment_count = 0;
+    bool ok = read_value(in, shard.shard_index) &&
+              read_value(in, shard.shard_count) &&
+              read_value(in, shard.sample_rate) &&
+              read_value(in, shard.core_start) &&
+              read_value(in, shard.core_end) &&
+              read_value(in, shard.range_start) &&
+              read_value(in, shard.range_end) &&
+              read_value(in, segment_count);
+    
+    for (uint64_t i = 0; ok && i < segment_count; i++) {
+        AudioSegment segment;
+        int64_t start = 0;
+        int64_t end = 0;
+        int32_t speaker_id = 0;
+        ok = read_value(in, start) && read_value(in, end) && 
+             read_value(in, speaker_id) && read_value(in, segment.confidence) &&
+             speaker_id >= 0 && speaker_id < kMaxLocalSpeakers;
+        segment.start_sample = start;
+        segment.end_sample = end;
+        segment.speaker_id = speaker_id;
+        shard.segments.push_back(std::move(segment));
+    }
+    
+    uint64_t centroid_count = 0;
+    ok = ok && read_value(in, centroid_count);
+    for (uint64_t i = 0; ok && i < centroid_count; i++) {
+        std::vector<float> centroid;
+        ok = read_floats(in, centroid);
+        shard.centroids.push_back(std::move(centroid));
+    }
+    
+    if (!ok) {
+        std::cerr << "❌ Truncated or corrupt shard file: " << path << std::endl;
+        return false;
+    }
+    
+    *this = std::move(shard);
+    return true;
+}
+
+ShardMerger::ShardMerger(float threshold, int max_speakers, bool verbose)
+    : threshold_(threshold),
+      max_speakers_(max_speakers),
+      verbose_(verbose) {
+}
+
+float ShardMerger::overlap_agreement(const ShardResult& a, int speaker_a,
+                                     const ShardResult& b, int speaker_b,
+                                     int64_t region_start, int64_t region_end) {
+    int64_t length_a = 0;
+    int64_t length_b = 0;
+    int64_t shared = 0;
+    
+    for (const auto& sa : a.segments) {
+        if (sa.speaker_id != speaker_a) continue;
+        length_a += clipped_length(sa.start_sample, sa.end_sample, region_start, region_end);
+        
+        for (const auto& sb : b.segments) {
+            if (sb.speaker_id != speaker_b) continue;
+            int64_t start = std::max(sa.start_sample, sb.start_sample);
+            int64_t end = std::min(sa.end_sample, sb.end_sample);
+            shared += clipped_length(start, end, region_start, region_end);
+        }
+    }
+    for (const auto& sb : b.segments) {
+        if (sb.speaker_id != speaker_b) continue;
+        length_b += clipped_length(sb.start_sample, sb.end_sample, region_start, region_end);
+    }
+    
+    if (length_a + length_b == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(2.0 * shared / static_cast<double>(length_a + length_b));
+}
+
+void ShardMerger::add_centroid(int global_id, const std::vector<float>& centroid) {
+    if (centroid.empty()) {
+        return;
+    }
+    
+    auto& global = global_centroids_[global_id];
+    int& count = global_counts_[global_id];
+    if (global.empty()) {
+        global = centroid;
+        count = 1;
+        return;
+    }
+    
+    for (size_t i = 0; i < global.size() && i < centroid.size(); i++) {
+        global[i] = (global[i] * count + centroid[i]) / (count + 1);
+    }
+    count++;
+    Utils::Math::normalize_vector(global);
+}
+
+std::vector<int> ShardMerger::link_shard(const ShardResult* previous, const std::vector<int>& previous_labels,
+                                         const ShardResult& shard) {
+    const size_t local_count = shard.local_speaker_count();
+    std::vector<int> labels(local_count, -1);
+    std::vector<bool> taken(global_centroids_.size(), false);
+    
+    auto centroid_similarity = [&](int global_id, size_t local) -> float {
+        if (local >= shard.centroids.size() || shard.centroids[local].empty() || 
+            global_centroids_[global_id].empty()) {
+            return -1.0f;
+        }
+        return Utils::Math::cosine_similarity(global_centroids_[global_id], shard.centroids[local]);
+    };
+    
+    // Greedy one-to-one assignment, best score first: local speakers of one shard are distinct people
+    auto assign_greedy = [&](std::vector<std::tuple<float, size_t, int>>& candidates, float min_score) {
+        std::sort(candidates.begin(), candidates.end(), [](const auto& x, const auto& y) {
+            return std::get<0>(x) > std::get<0>(y);
+        });
+        for (const auto& [score, local, global_id] : candidates) {
+            if (score < min_score) break;
+            if (labels[local] >= 0 || taken[global_id]) continue;
+            labels[local] = global_id;
+            taken[global_id] = true;
+        }
+    };
+    
+    // Step 1: Speakers active in the overlap with the previous shard
+    if (previous) {
+        const int64_t region_start = std::max(previous->range_start, shard.range_start);
+        const int64_t region_end = std::min(previous->range_end, shard.range_end);
+        
+        std::vector<std::tuple<float, size_t, int>> candidates;
+        for (size_t a = 0; a < previous_labels.size(); a++) {
+            int global_id = previous_labels[a];
+            for (size_t b = 0; b < local_count; b++) {
+                float agreement = overlap_agreement(*previous, static_cast<int>(a), shard, static_cast<int>(b),
+                                                    region_start, region_end);
+                if (agreement <= 0.0f) continue;
+                
+                float similarity = centroid_similarity(global_id, b);
+                float score = similarity < -0.5f ? agreement : 0.5f * (agreement + similarity);
+                candidates.emplace_back(score, b, global_id);
+            }
+        }
+        assign_greedy(candidates, kLinkThreshold);
+    }
+    
+    // Step 2: Speakers returning after a gap, by centroid similarity alone
+    {
+        std::vector<std::tuple<float, size_t, int>> candidates;
+        for (size_t b = 0; b < local_count; b++) {
+            if (labels[b] >= 0) continue;
+            for (size_t g = 0; g < global_centroids_.size(); g++) {
+                float similarity = centroid_similarity(static_cast<int>(g), b);
+                if (similarity > threshold_) {
+                    candidates.emplace_back(similarity, b, static_cast<int>(g));
+                }
+            }
+        }
+        assign_greedy(candidates, threshold_);
+    }
+    
+    // Step 3: New global speakers, or the closest one once the limit is reached
+    for (size_t b = 0; b < local_count; b++) {
+        if (labels[b] >= 0) continue;
+        
+        if (static_cast<int>(global_centroids_.size()) < max_speakers_) {
+            labels[b] = static_cast<int>(global_centroids_.size());
+            global_centroids_.emplace_back();
+            global_counts_.push_back(0);
+            continue;
+        }
+        
+        int best = 0;
+        float best_similarity = -2.0f;
+        for (size_t g = 0; g < global_centroids_.size(); g++) {
+            float similarity = centroid_similarity(static_cast<int>(g), b);
+            if (similarity > best_similarity) {
+                best_similarity = similarity;
+                best = static_cast<int>(g);
+            }
+        }
+        labels[b] = best;
+    }
+    
+    for (size_t b = 0; b < local_count && b < shard.centroids.size(); b++) {
+        add_centroid(labels[b], shard.centroids[b]);
+    }
+    
+    return labels;
+}
+
+std::vector<AudioSegment> ShardMerger::merge(const std::vector<ShardResult>& shards) {
+    global_centroids_.clear();
+    global_counts_.clear();
+    
+    std::vector<AudioSegment> merged;
+    std::vector<int> previous_labels;
+    const ShardResult* previous = nullptr;
+    
+    for (const auto& shard : shards) {
+        auto labels = link_shard(previous, previous_labels, shard);
+        
+        if (verbose_) {
+            std::cout << "🧩 Shard " << shard.shard_index << ": " << labels.size() << " local speakers ->";
+            for (int label : labels) {
+                std::cout << " " << label;
+            }
+            std::cout << std::endl;
+        }
+        
+        // Each shard only reports its core range; the overlap belongs to the neighbour
+        for (const auto& segment : shard.segments) {
+            if (segment.speaker_id < 0 || static_cast<size_t>(segment.speaker_id) >= labels.size()) {
+                throw std::runtime_error("Shard " + std::to_string(shard.shard_index) + 
+                                         " has an invalid speaker ID: " + std::to_string(segment.speaker_id));
+            }
+            
+            int64_t start = std::max(segment.start_sample, shard.core_start);
+            int64_t end = std::min(segment.end_sample, shard.core_end);
+            if (end <= start) continue;
+            
+            AudioSegment clipped;
+            clipped.start_sample = start;
+            clipped.end_sample = end;
+            clipped.speaker_id = labels[segment.speaker_id];
+            clipped.confidence = segment.confidence;
+            merged.push_back(std::move(clipped));
+        }
+        
+        previous = &shard;
+        previous_labels = std::move(labels);
+    }
+    
+    std::sort(merged.begin(), merged.end(), [](const AudioSegment& a, const AudioSegment& b) {
+        return a.start_sample < b.start_sample;
+    });
+    
+    // Re-join segments cut at shard boundaries
+    std::vector<AudioSegment> result;
+    std::map<int, size_t> last_segment;  // Speaker -> index of its latest segment in result
+    for (auto& segment : merged) {
+        auto it = last_segment.find(segment.speaker_id);
+        if (it != last_segment.end() && result[it->second].end_sample >= segment.start_sample) {
+            auto& last = result[it->second];
+            double last_length = static_cast<double>(last.end_sample - last.start_sample);
+            double length = static_cast<double>(segment.end_sample - segment.start_sample);
+            last.confidence = static_cast<float>((last.confidence * last_length + segment.confidence * length) /
+                                                 std::max(1.0, last_length + length));
+            last.end_sample = std::max(last.end_sample, segment.end_sample);
+            continue;
+        }
+        
+        last_segment[segment.speaker_id] = result.size();
+        result.push_back(std::move(segment));
+    }
+    
+    return result;
+}
@@ -0,0 +1,153 @@
+// src/native/diarization/signal-filters.cpp
+#include "signal-filters.h"
+#include <algorithm>
+
+namespace Signal {
+
+PeakPicker::PeakPicker(float threshold, size_t min_distance)
+    : threshold_(threshold),
+      min_distance_(min_distance),
+      pushed_(0),
+      indices_(2 * min_distance + 1),
+      values_(2 * min_distance + 1),
+      head_(0),
+      size_(0) {
+}
+
+void PeakPicker::reset() {
+    pushed_ = 0;
+    head_ = 0;
+    size_ = 0;
+}
+
+void PeakPicker::push(const float* values, size_t count, std::vector<size_t>& peaks) {
+    const size_t span = 2 * min_distance_;
+    
+    for (size_t i = 0; i < count; i++) {
+        const size_t k = pushed_++;
+        const float value = values[i];
+        
+        // Drop the index that left the window [k - 2d, k]
+        if (size_ > 0 && indices_[head_] + span < k) {
+            head_ = slot(1);
+            size_--;
+        }
+        
+        // Values below the new one can no longer be a neighbourhood maximum; equal ones
+        // stay, so a tie still disqualifies the later of the two
+        while (size_ > 0 && values_[slot(size_ - 1)] < value) {
+            size_--;
+        }
+        indices_[slot(size_)] = k;
+        values_[slot(size_)] = value;
+        size_++;
+        
+        // The neighbourhood of k - d is complete: it is a peak if it is the front and nothing ties it
+        if (k >= span) {
+            const size_t center = k - min_distance_;
+            if (indices_[head_] == center && values_[head_] > threshold_ &&
+                (size_ == 1 || values_[slot(1)] < values_[head_])) {
+                peaks.push_back(center);
+            }
+        }
+    }
+}
+
+RunningMedian::RunningMedian(size_t width)
+    : width_(std::max<size_t>(1, width) | 1),
+      half_(width_ / 2),
+      pushed_(0),
+      emitted_(0),
+      ring_(width_) {
+    sorted_.reserve(width_);
+}
+
+void RunningMedian::remove_oldest() {
+    const float oldest = ring_[(pushed_ - sorted_.size()) % width_];
+    sorted_.erase(std::lower_bound(sorted_.begin(), sorted_.end(), oldest));
+}
+
+float RunningMedian::median() const {
+    const size_t n = sorted_.size();
+    return n % 2 ? sorted_[n / 2] : 0.5f * (sorted_[n / 2 - 1] + sorted_[n / 2]);
+}
+
+void RunningMedian::push(const float* values, size_t count, std::vector<float>& out) {
+    for (size_t i = 0; i < count; i++) {
+        if (sorted_.size() == width_) {
+            remove_oldest();
+        }
+        sorted_.insert(std::upper_bound(sorted_.begin(), sorted_.end(), values[i]), values[i]);
+        ring_[pushed_ % width_] = values[i];
+        pushed_++;
+        
+        // The window of value emitted_ now reaches half_ values past it
+        if (pushed_ > half_) {
+            out.push_back(median());
+            emitted_++;
+        }
+    }
+}
+
+void RunningMedian::finish(std::vector<float>& out) {
+    // The last half_ windows run past the end; they shrink from the front only
+    for (; emitted_ < pushed_; emitted_++) {
+        while (emitted_ >= half_ && pushed_ - sorted_.size() < emitted_ - half_) {
+            remove_oldest();
+        }
+        out.push_back(median());
+    }
+    pushed_ = 0;
+    emitted_ = 0;
+    sorted_.clear();
+}
+
+Hysteresis::Hysteresis(float onset, float offset)
+    : onset_(onset), offset_(offset), pushed_(0), active_(false), start_(0) {
+}
+
+void Hysteresis::push(const float* values, size_t count, std::vector<Region>& regions) {
+    for (size_t i = 0; i < count; i++, pushed_++) {
+        if (!active_ && values[i] >= onset_) {
+            active_ = true;
+            start_ = pushed_;
+        } else if (active_ && values[i] < offset_) {
+            regions.push_back({start_, pushed_});
+            active_ = false;
+        }
+    }
+}
+
+void Hysteresis::finish(std::vector<Region>& regions) {
+    if (active_) {
+        regions.push_back({start_, pushed_});
+    }
+    pushed_ = 0;
+    active_ = false;
+}
+
+std::vector<size_t> find_peaks(const float* values, size_t count, float threshold, size_t min_distance) {
+    std::vector<size_t> peaks;
+    PeakPicker picker(threshold, min_distance);
+    picker.push(values, count, peaks);
+    return peaks;
+}
+
+std::vector<float> median_filter(const float* values, size_t count, size_t width) {
+    std::vector<float> out;
+    out.reserve(count);
+    RunningMedian filter(width);
+    filter.push(values, count, out);
+    filter.finish(out);
+    return out;
+}
+
+std::vector<Region> binarize(const float* values, size_t count, float onset, float offset) {
+    std::vector<Region> regions;
+    Hysteresis hysteresis(onset, offset);
+    hysteresis.push(values, count, regions);
+    hysteresis.finish(regions);
+    return regions;
+}
+
+} // namespace Signal
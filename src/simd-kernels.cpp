@@ -0,0 +1,653 @@
+// src/native/diarization/simd-kernels.cpp
+#include "simd-kernels.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define KERNEL_TARGET(isa)
+#else
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SIMD_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+using DotKernel = float (*)(const float*, const float*, size_t);
+using ScaleKernel = void (*)(float*, float, size_t);
+
+// Embedding sizes of the supported models get fixed-length kernels: no tail, fully unrolled
+constexpr size_t kFixedSizes = 3;
+
+int fixed_slot(size_t n) {
+    switch (n) {
+        case 192: return 0;
+        case 256: return 1;
+        case 512: return 2;
+        default: return -1;
+    }
+}
+
+struct KernelTable {
+    const char* name;
+    DotKernel dot;
+    float (*max_abs)(const float*, size_t);
+    ScaleKernel scale;
+    void (*scaled_add)(float*, const float*, float, size_t);
+    void (*gain_emphasis)(float*, const float*, float, float, size_t);
+    int32_t (*max_abs_pcm16)(const int16_t*, size_t);
+    void (*pcm16_emphasis)(float*, const int16_t*, float, float, size_t);
+    DotKernel dot_fixed[kFixedSizes];      // 192, 256, 512
+    ScaleKernel scale_fixed[kFixedSizes];
+};
+
+// Scalar reference kernels
+float dot_scalar(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+float max_abs_scalar(const float* a, size_t n) {
+    float max_val = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        max_val = std::max(max_val, std::abs(a[i]));
+    }
+    return max_val;
+}
+
+void scale_scalar(float* a, float alpha, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        a[i] *= alpha;
+    }
+}
+
+void scaled_add_scalar(float* y, const float* x, float alpha, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+void gain_emphasis_scalar(float* y, const float* x, float gain, float coeff, size_t n) {
+    float previous = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        const float current = x[i] * gain;
+        y[i] = current - coeff * previous;
+        previous = current;
+    }
+}
+
+int32_t max_abs_pcm16_scalar(const int16_t* a, size_t n) {
+    int32_t max_val = 0;
+    for (size_t i = 0; i < n; i++) {
+        max_val = std::max(max_val, std::abs(static_cast<int32_t>(a[i])));
+    }
+    return max_val;
+}
+
+void pcm16_emphasis_scalar(float* y, const int16_t* x, float gain, float coeff, size_t n) {
+    float previous = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        const float current = x[i] * gain;
+        y[i] = current - coeff * previous;
+        previous = current;
+    }
+}
+
+// Constant trip counts let the compiler unroll and vectorize for the baseline ISA
+template <size_t N>
+float dot_scalar_fixed(const float* a, const float* b, size_t) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < N; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+template <size_t N>
+void scale_scalar_fixed(float* a, float alpha, size_t) {
+    for (size_t i = 0; i < N; i++) {
+        a[i] *= alpha;
+    }
+}
+
+const KernelTable kScalar = {"scalar", dot_scalar, max_abs_scalar, scale_scalar, scaled_add_scalar, gain_emphasis_scalar,
+                             max_abs_pcm16_scalar, pcm16_emphasis_scalar,
+                             {dot_scalar_fixed<192>, dot_scalar_fixed<256>, dot_scalar_fixed<512>},
+                             {scale_scalar_fixed<192>, scale_scalar_fixed<256>, scale_scalar_fixed<512>}};
+
+#ifdef SIMD_KERNELS_X86
+// AVX2 + FMA: 8 lanes, two accumulators to hide the FMA latency
+KERNEL_TARGET("avx2,fma") inline float hsum_avx2(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+KERNEL_TARGET("avx2,fma") float dot_avx2(const float* a, const float* b, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    float sum = hsum_avx2(_mm256_add_ps(acc0, acc1));
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+KERNEL_TARGET("avx2,fma") float max_abs_avx2(const float* a, size_t n) {
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 max_vec = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        max_vec = _mm256_max_ps(max_vec, _mm256_and_ps(_mm256_loadu_ps(a + i), abs_mask));
+    }
+    __m128 max4 = _mm_max_ps(_mm256_castps256_ps128(max_vec), _mm256_extractf128_ps(max_vec, 1));
+    max4 = _mm_max_ps(max4, _mm_movehl_ps(max4, max4));
+    max4 = _mm_max_ss(max4, _mm_shuffle_ps(max4, max4, 1));
+    float max_val = _mm_cvtss_f32(max4);
+    for (; i < n; i++) {
+        max_val = std::max(max_val, std::abs(a[i]));
+    }
+    return max_val;
+}
+
+KERNEL_TARGET("avx2,fma") void scale_avx2(float* a, float alpha, size_t n) {
+    const __m256 factor = _mm256_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(a + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), factor));
+    }
+    for (; i < n; i++) {
+        a[i] *= alpha;
+    }
+}
+
+KERNEL_TARGET("avx2,fma") void scaled_add_avx2(float* y, const float* x, float alpha, size_t n) {
+    const __m256 factor = _mm256_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(factor, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+    for (; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+// The previous sample is an unaligned load one element back, so there is no carried dependency
+KERNEL_TARGET("avx2,fma") void gain_emphasis_avx2(float* y, const float* x, float gain, float coeff, size_t n) {
+    if (n == 0) return;
+    y[0] = x[0] * gain;
+    const __m256 factor = _mm256_set1_ps(gain);
+    const __m256 emphasis = _mm256_set1_ps(coeff);
+    size_t i = 1;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 current = _mm256_mul_ps(_mm256_loadu_ps(x + i), factor);
+        const __m256 previous = _mm256_mul_ps(_mm256_loadu_ps(x + i - 1), factor);
+        _mm256_storeu_ps(y + i, _mm256_fnmadd_ps(emphasis, previous, current));
+    }
+    for (; i < n; i++) {
+        y[i] = x[i] * gain - coeff * (x[i - 1] * gain);
+    }
+}
+
+// |-32768| does not fit in int16: abs wraps it to 0x8000, which an unsigned max reads as 32768
+KERNEL_TARGET("avx2,fma") int32_t max_abs_pcm16_avx2(const int16_t* a, size_t n) {
+    __m256i max_vec = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        max_vec = _mm256_max_epu16(max_vec, _mm256_abs_epi16(samples));
+    }
+    // Largest of 8 unsigned lanes: the smallest of their complements
+    __m128i max8 = _mm_max_epu16(_mm256_castsi256_si128(max_vec), _mm256_extracti128_si256(max_vec, 1));
+    max8 = _mm_minpos_epu16(_mm_xor_si128(max8, _mm_set1_epi16(-1)));
+    int32_t max_val = 0xffff - (_mm_cvtsi128_si32(max8) & 0xffff);
+    for (; i < n; i++) {
+        max_val = std::max(max_val, std::abs(static_cast<int32_t>(a[i])));
+    }
+    return max_val;
+}
+
+KERNEL_TARGET("avx2,fma") inline __m256 load_pcm16_avx2(const int16_t* x) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x))));
+}
+
+KERNEL_TARGET("avx2,fma") void pcm16_emphasis_avx2(float* y, const int16_t* x, float gain, float coeff, size_t n) {
+    if (n == 0) return;
+    y[0] = x[0] * gain;
+    const __m256 factor = _mm256_set1_ps(gain);
+    const __m256 emphasis = _mm256_set1_ps(coeff);
+    size_t i = 1;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 current = _mm256_mul_ps(load_pcm16_avx2(x + i), factor);
+        const __m256 previous = _mm256_mul_ps(load_pcm16_avx2(x + i - 1), factor);
+        _mm256_storeu_ps(y + i, _mm256_fnmadd_ps(emphasis, previous, current));
+    }
+    for (; i < n; i++) {
+        y[i] = x[i] * gain - coeff * (x[i - 1] * gain);
+    }
+}
+
+template <size_t N>
+KERNEL_TARGET("avx2,fma") float dot_avx2_fixed(const float* a, const float* b, size_t) {
+    static_assert(N % 16 == 0, "fixed AVX2 dot needs a multiple of 16");
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (size_t i = 0; i < N; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    return hsum_avx2(_mm256_add_ps(acc0, acc1));
+}
+
+template <size_t N>
+KERNEL_TARGET("avx2,fma") void scale_avx2_fixed(float* a, float alpha, size_t) {
+    static_assert(N % 8 == 0, "fixed AVX2 scale needs a multiple of 8");
+    const __m256 factor = _mm256_set1_ps(alpha);
+    for (size_t i = 0; i < N; i += 8) {
+        _mm256_storeu_ps(a + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), factor));
+    }
+}
+
+const KernelTable kAvx2 = {"avx2", dot_avx2, max_abs_avx2, scale_avx2, scaled_add_avx2, gain_emphasis_avx2,
+                           max_abs_pcm16_avx2, pcm16_emphasis_avx2,
+                           {dot_avx2_fixed<192>, dot_avx2_fixed<256>, dot_avx2_fixed<512>},
+                           {scale_avx2_fixed<192>, scale_avx2_fixed<256>, scale_avx2_fixed<512>}};
+
+// GCC's AVX-512 headers trip -Wuninitialized on their own undefined-vector placeholders
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// AVX-512: 16 lanes, masked loads handle the tail without a scalar loop
+KERNEL_TARGET("avx512f") float dot_avx512(const float* a, const float* b, size_t n) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    }
+    if (i < n) {
+        const __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(tail, a + i), _mm512_maskz_loadu_ps(tail, b + i), acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+KERNEL_TARGET("avx512f") float max_abs_avx512(const float* a, size_t n) {
+    __m512 max_vec = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        max_vec = _mm512_max_ps(max_vec, _mm512_abs_ps(_mm512_loadu_ps(a + i)));
+    }
+    if (i < n) {
+        const __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+        max_vec = _mm512_max_ps(max_vec, _mm512_abs_ps(_mm512_maskz_loadu_ps(tail, a + i)));
+    }
+    return _mm512_reduce_max_ps(max_vec);
+}
+
+KERNEL_TARGET("avx512f") void scale_avx512(float* a, float alpha, size_t n) {
+    const __m512 factor = _mm512_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(a + i, _mm512_mul_ps(_mm512_loadu_ps(a + i), factor));
+    }
+    if (i < n) {
+        const __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(a + i, tail, _mm512_mul_ps(_mm512_maskz_loadu_ps(tail, a + i), factor));
+    }
+}
+
+KERNEL_TARGET("avx512f") void scaled_add_avx512(float* y, const float* x, float alpha, size_t n) {
+    const __m512 factor = _mm512_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(y + i, _mm512_fmadd_ps(factor, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+    }
+    if (i < n) {
+        const __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(y + i, tail, _mm512_fmadd_ps(factor, _mm512_maskz_loadu_ps(tail, x + i),
+                                                           _mm512_maskz_loadu_ps(tail, y + i)));
+    }
+}
+
+KERNEL_TARGET("avx512f") void gain_emphasis_avx512(float* y, const float* x, float gain, float coeff, size_t n) {
+    if (n == 0) return;
+    y[0] = x[0] * gain;
+    const __m512 factor = _mm512_set1_ps(gain);
+    const __m512 emphasis = _mm512_set1_ps(coeff);
+    size_t i = 1;
+    for (; i + 16 <= n; i += 16) {
+        const __m512 current = _mm512_mul_ps(_mm512_loadu_ps(x + i), factor);
+        const __m512 previous = _mm512_mul_ps(_mm512_loadu_ps(x + i - 1), factor);
+        _mm512_storeu_ps(y + i, _mm512_fnmadd_ps(emphasis, previous, current));
+    }
+    if (i < n) {
+        const __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+        const __m512 current = _mm512_mul_ps(_mm512_maskz_loadu_ps(tail, x + i), factor);
+        const __m512 previous = _mm512_mul_ps(_mm512_maskz_loadu_ps(tail, x + i - 1), factor);
+        _mm512_mask_storeu_ps(y + i, tail, _mm512_fnmadd_ps(emphasis, previous, current));
+    }
+}
+
+// Sign extension of 16 samples is AVX-512F; the tail stays scalar since masked 16-bit loads need AVX512BW
+KERNEL_TARGET("avx512f") inline __m512 load_pcm16_avx512(const int16_t* x) {
+    return _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x))));
+}
+
+KERNEL_TARGET("avx512f") void pcm16_emphasis_avx512(float* y, const int16_t* x, float gain, float coeff, size_t n) {
+    if (n == 0) return;
+    y[0] = x[0] * gain;
+    const __m512 factor = _mm512_set1_ps(gain);
+    const __m512 emphasis = _mm512_set1_ps(coeff);
+    size_t i = 1;
+    for (; i + 16 <= n; i += 16) {
+        const __m512 current = _mm512_mul_ps(load_pcm16_avx512(x + i), factor);
+        const __m512 previous = _mm512_mul_ps(load_pcm16_avx512(x + i - 1), factor);
+        _mm512_storeu_ps(y + i, _mm512_fnmadd_ps(emphasis, previous, current));
+    }
+    for (; i < n; i++) {
+        y[i] = x[i] * gain - coeff * (x[i - 1] * gain);
+    }
+}
+
+template <size_t N>
+KERNEL_TARGET("avx512f") float dot_avx512_fixed(const float* a, const float* b, size_t) {
+    static_assert(N % 32 == 0, "fixed AVX-512 dot needs a multiple of 32");
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (size_t i = 0; i < N; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+template <size_t N>
+KERNEL_TARGET("avx512f") void scale_avx512_fixed(float* a, float alpha, size_t) {
+    static_assert(N % 16 == 0, "fixed AVX-512 scale needs a multiple of 16");
+    const __m512 factor = _mm512_set1_ps(alpha);
+    for (size_t i = 0; i < N; i += 16) {
+        _mm512_storeu_ps(a + i, _mm512_mul_ps(_mm512_loadu_ps(a + i), factor));
+    }
+}
+
+const KernelTable kAvx512 = {"avx512", dot_avx512, max_abs_avx512, scale_avx512, scaled_add_avx512, gain_emphasis_avx512,
+                             max_abs_pcm16_avx2, pcm16_emphasis_avx512,
+                             {dot_avx512_fixed<192>, dot_avx512_fixed<256>, dot_avx512_fixed<512>},
+                             {scale_avx512_fixed<192>, scale_avx512_fixed<256>, scale_avx512_fixed<512>}};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+bool cpu_supports_avx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    const bool os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+    const bool fma = info[2] & (1 << 12);
+    __cpuidex(info, 7, 0);
+    return os_avx && fma && (info[1] & (1 << 5));
+#else
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+bool cpu_supports_avx512() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 0xe6) != 0xe6) {
+        return false;  // The OS does not save the ZMM and mask registers
+    }
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 16);
+#else
+    return __builtin_cpu_supports("avx512f");
+#endif
+}
+#endif
+
+#ifdef SIMD_KERNELS_NEON
+// NEON: 4 lanes, always available on arm64
+float dot_neon(const float* a, const float* b, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+float max_abs_neon(const float* a, size_t n) {
+    float32x4_t max_vec = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        max_vec = vmaxq_f32(max_vec, vabsq_f32(vld1q_f32(a + i)));
+    }
+    float max_val = vmaxvq_f32(max_vec);
+    for (; i < n; i++) {
+        max_val = std::max(max_val, std::abs(a[i]));
+    }
+    return max_val;
+}
+
+void scale_neon(float* a, float alpha, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(a + i, vmulq_n_f32(vld1q_f32(a + i), alpha));
+    }
+    for (; i < n; i++) {
+        a[i] *= alpha;
+    }
+}
+
+void scaled_add_neon(float* y, const float* x, float alpha, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(y + i, vfmaq_n_f32(vld1q_f32(y + i), vld1q_f32(x + i), alpha));
+    }
+    for (; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+void gain_emphasis_neon(float* y, const float* x, float gain, float coeff, size_t n) {
+    if (n == 0) return;
+    y[0] = x[0] * gain;
+    const float32x4_t emphasis = vdupq_n_f32(coeff);
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t current = vmulq_n_f32(vld1q_f32(x + i), gain);
+        const float32x4_t previous = vmulq_n_f32(vld1q_f32(x + i - 1), gain);
+        vst1q_f32(y + i, vfmsq_f32(current, previous, emphasis));
+    }
+    for (; i < n; i++) {
+        y[i] = x[i] * gain - coeff * (x[i - 1] * gain);
+    }
+}
+
+int32_t max_abs_pcm16_neon(const int16_t* a, size_t n) {
+    uint16x8_t max_vec = vdupq_n_u16(0);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        // abs wraps -32768 to 0x8000, read as unsigned that is 32768
+        max_vec = vmaxq_u16(max_vec, vreinterpretq_u16_s16(vabsq_s16(vld1q_s16(a + i))));
+    }
+    int32_t max_val = vmaxvq_u16(max_vec);
+    for (; i < n; i++) {
+        max_val = std::max(max_val, std::abs(static_cast<int32_t>(a[i])));
+    }
+    return max_val;
+}
+
+void pcm16_emphasis_neon(float* y, const int16_t* x, float gain, float coeff, size_t n) {
+    if (n == 0) return;
+    y[0] = x[0] * gain;
+    const float32x4_t emphasis = vdupq_n_f32(coeff);
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t current = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(x + i))), gain);
+        const float32x4_t previous = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(x + i - 1))), gain);
+        vst1q_f32(y + i, vfmsq_f32(current, previous, emphasis));
+    }
+    for (; i < n; i++) {
+        y[i] = x[i] * gain - coeff * (x[i - 1] * gain);
+    }
+}
+
+template <size_t N>
+float dot_neon_fixed(const float* a, const float* b, size_t) {
+    static_assert(N % 8 == 0, "fixed NEON dot needs a multiple of 8");
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < N; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1));
+}
+
+template <size_t N>
+void scale_neon_fixed(float* a, float alpha, size_t) {
+    static_assert(N % 4 == 0, "fixed NEON scale needs a multiple of 4");
+    for (size_t i = 0; i < N; i += 4) {
+        vst1q_f32(a + i, vmulq_n_f32(vld1q_f32(a + i), alpha));
+    }
+}
+
+const KernelTable kNeon = {"neon", dot_neon, max_abs_neon, scale_neon, scaled_add_neon, gain_emphasis_neon,
+                           max_abs_pcm16_neon, pcm16_emphasis_neon,
+                           {dot_neon_fixed<192>, dot_neon_fixed<256>, dot_neon_fixed<512>},
+                           {scale_neon_fixed<192>, scale_neon_fixed<256>, scale_neon_fixed<512>}};
+#endif
+
+const KernelTable& select_kernels() {
+    const char* forced = std::getenv("DIARIZATION_KERNELS");
+    const bool force_scalar = forced && std::strcmp(forced, "scalar") == 0;
+    if (force_scalar) {
+        return kScalar;
+    }
+
+#ifdef SIMD_KERNELS_X86
+    const bool avx512 = cpu_supports_avx512();
+    const bool avx2 = cpu_supports_avx2();
+    if (forced && std::strcmp(forced, "avx512") == 0 && avx512) {
+        return kAvx512;
+    }
+    if (forced && std::strcmp(forced, "avx2") == 0 && avx2) {
+        return kAvx2;
+    }
+    if (avx512) return kAvx512;
+    if (avx2) return kAvx2;
+#elif defined(SIMD_KERNELS_NEON)
+    return kNeon;
+#endif
+    return kScalar;
+}
+
+const KernelTable& kernels() {
+    static const KernelTable& selected = select_kernels();
+    return selected;
+}
+
+// Fixed-length kernel for the supported embedding sizes, the generic one otherwise
+DotKernel dot_kernel(size_t n) {
+    const int slot = fixed_slot(n);
+    return slot >= 0 ? kernels().dot_fixed[slot] : kernels().dot;
+}
+
+ScaleKernel scale_kernel(size_t n) {
+    const int slot = fixed_slot(n);
+    return slot >= 0 ? kernels().scale_fixed[slot] : kernels().scale;
+}
+
+} // namespace
+
+namespace SimdKernels {
+
+float dot(const float* a, const float* b, size_t n) {
+    return dot_kernel(n)(a, b, n);
+}
+
+float norm(const float* a, size_t n) {
+    return std::sqrt(dot_kernel(n)(a, a, n));
+}
+
+void normalize(float* a, size_t n) {
+    const float length = norm(a, n);
+    if (length > 1e-6f) {
+        scale_kernel(n)(a, 1.0f / length, n);
+    }
+}
+
+void scale(float* a, float alpha, size_t n) {
+    scale_kernel(n)(a, alpha, n);
+}
+
+void scaled_add(float* y, const float* x, float alpha, size_t n) {
+    kernels().scaled_add(y, x, alpha, n);
+}
+
+float max_abs(const float* a, size_t n) {
+    return kernels().max_abs(a, n);
+}
+
+void gain_emphasis(float* y, const float* x, float gain, float coeff, size_t n) {
+    kernels().gain_emphasis(y, x, gain, coeff, n);
+}
+
+int32_t max_abs_pcm16(const int16_t* a, size_t n) {
+    return kernels().max_abs_pcm16(a, n);
+}
+
+void pcm16_emphasis(float* y, const int16_t* x, float gain, float coeff, size_t n) {
+    kernels().pcm16_emphasis(y, x, gain, coeff, n);
+}
+
+void gemv(const float* matrix, size_t rows, size_t cols, const float* x, float* y) {
+    // A dot product per row; x stays in L1 across rows
+    const DotKernel row_dot = dot_kernel(cols);
+    for (size_t r = 0; r < rows; r++) {
+        y[r] = row_dot(matrix + r * cols, x, cols);
+    }
+}
+
+const char* isa() {
+    return kernels().name;
+}
+
+} // namespace SimdKernels
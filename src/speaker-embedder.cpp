@@ -1,9 +1,13 @@
 // src/native/diarization/speaker-embedder.cpp - FIXED for Windows ONNX Runtime
 #include "speaker-embedder.h"
 #include "utils.h"
+#include "execution-provider.h"
+#include "allocation-counter.h"
+#include "simd-kernels.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -15,7 +19,13 @@ SpeakerEmbedder::SpeakerEmbedder(bool verbose)
       verbose_(verbose),
       target_length_(48000),  // 3 seconds at 16kHz
       sample_rate_(16000),
-      embedding_dim_(512) {   // Default embedding dimension
+      embedding_dim_(512),    // Default embedding dimension
+      max_batch_size_(1),
+      inference_count_(0),
+      intra_op_threads_(4),
+      provider_("cpu"),
+      provider_used_("cpu"),
+      terminated_(false) {
     
     // Configure session options for optimal performance
     session_options_.SetIntraOpNumThreads(4);
@@ -27,6 +37,18 @@ SpeakerEmbedder::SpeakerEmbedder(bool verbose)
 
 SpeakerEmbedder::~SpeakerEmbedder() = default;
 
+void SpeakerEmbedder::set_intra_op_threads(int threads, bool allow_spinning) {
+    intra_op_threads_ = threads;
+    session_options_.SetIntraOpNumThreads(threads);
+    session_options_.AddConfigEntry("session.intra_op.allow_spinning", allow_spinning ? "1" : "0");
+}
+
+void SpeakerEmbedder::set_thread_affinities(const std::string& affinities) {
+    if (!affinities.empty()) {
+        session_options_.AddConfigEntry("session.intra_op_thread_affinities", affinities.c_str());
+    }
+}
+
 bool SpeakerEmbedder::initialize(const std::string& model_path, int sample_rate, float target_duration) {
     try {
         if (verbose_) {
@@ -36,13 +58,8 @@ bool SpeakerEmbedder::initialize(const std::string& model_path, int sample_rate,
         sample_rate_ = sample_rate;
         target_length_ = static_cast<size_t>(target_duration * sample_rate);
         
-        // FIXED: Windows requires wstring for ONNX Runtime model path
-#ifdef _WIN32
-        auto wmodel_path = string_to_wstring(model_path);
-        session_ = std::make_unique<Ort::Session>(env_, wmodel_path.c_str(), session_options_);
-#else
-        session_ = std::make_unique<Ort::Session>(env_, model_path.c_str(), session_options_);
-#endif
+        session_ = ExecutionProvider::create_session(env_, model_path, session_options_, provider_,
+                                                     intra_op_threads_, provider_used_, verbose_);
         
         // Get output shape to determine embedding dimension
         auto output_info = session_->GetOutputTypeInfo(0);
@@ -55,6 +72,24 @@ bool SpeakerEmbedder::initialize(const std::string& model_path, int sample_rate,
             embedding_dim_ *= static_cast<size_t>(shape[i]);
         }
         
+        // A dynamic batch dimension (-1) lets us run many segments per call
+        auto input_shape = session_->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (!input_shape.empty() && input_shape[0] > 0) {
+            max_batch_size_ = static_cast<size_t>(input_shape[0]);
+        } else {
+            max_batch_size_ = std::numeric_limits<size_t>::max();
+        }
+        
+        input_name_ = session_->GetInputNameAllocated(0, Ort::AllocatorWithDefaultOptions()).get();
+        output_name_ = session_->GetOutputNameAllocated(0, Ort::AllocatorWithDefaultOptions()).get();
+        output_shape_ = shape;
+        for (size_t i = 1; i < output_shape_.size(); i++) {
+            if (output_shape_[i] <= 0) {
+                output_shape_.clear();
+                break;
+            }
+        }
+        
         if (verbose_) {
             auto input_count = session_->GetInputCount();
             auto output_count = session_->GetOutputCount();
@@ -62,8 +97,10 @@ bool SpeakerEmbedder::initialize(const std::string& model_path, int sample_rate,
             std::cout << "Embedding model loaded:" << std::endl;
             std::cout << "  Inputs: " << input_count << std::endl;
             std::cout << "  Outputs: " << output_count << std::endl;
+            std::cout << "  Provider: " << provider_used_ << std::endl;
             std::cout << "  Target length: " << target_length_ << " samples" << std::endl;
             std::cout << "  Embedding dimension: " << embedding_dim_ << std::endl;
+            std::cout << "  Batching: " << (max_batch_size_ > 1 ? "dynamic" : "fixed batch of 1") << std::endl;
         }
         
         return true;
@@ -74,6 +111,16 @@ bool SpeakerEmbedder::initialize(const std::string& model_path, int sample_rate,
     }
 }
 
+void SpeakerEmbedder::terminate() {
+    terminated_ = true;
+    run_options_.SetTerminate();
+}
+
+void SpeakerEmbedder::clear_terminate() {
+    run_options_.UnsetTerminate();
+    terminated_ = false;
+}
+
 std::vector<float> SpeakerEmbedder::extract_embedding(const std::vector<float>& audio_segment) {
     if (!is_initialized()) {
         std::cerr << "❌ Embedder not initialized" << std::endl;
@@ -81,35 +128,15 @@ std::vector<float> SpeakerEmbedder::extract_embedding(const std::vector<float>&
     }
     
     try {
-        // Prepare audio segment (pad/truncate and normalize)
-        auto prepared_audio = prepare_audio_segment(audio_segment);
-        
-        // Get actual input/output names from the model
-        auto input_name = session_->GetInputNameAllocated(0, Ort::AllocatorWithDefaultOptions());
-        auto output_name = session_->GetOutputNameAllocated(0, Ort::AllocatorWithDefaultOptions());
-        
         if (verbose_) {
-            std::cout << "Embedding - Using input name: " << input_name.get() << std::endl;
-            std::cout << "Embedding - Using output name: " << output_name.get() << std::endl;
+            std::cout << "Embedding - Using input name: " << input_name_ << std::endl;
+            std::cout << "Embedding - Using output name: " << output_name_ << std::endl;
         }
         
-        // FIXED: Create 2D input tensor for embedding model (batch_size, samples)
-        // The embedding model expects [batch, samples] not [batch, channels, samples]
-        std::vector<int64_t> input_shape = {1, static_cast<int64_t>(target_length_)};
-        auto input_tensor = Ort::Value::CreateTensor<float>(
-            memory_info_, prepared_audio.data(), prepared_audio.size(),
-            input_shape.data(), input_shape.size());
-        
-        // Run inference with correct names
-        std::vector<const char*> input_names = {input_name.get()};
-        std::vector<const char*> output_names = {output_name.get()};
-        
-        auto output_tensors = session_->Run(Ort::RunOptions{nullptr},
-                                          input_names.data(), &input_tensor, 1,
-                                          output_names.data(), 1);
+        const std::vector<float>* segment = &audio_segment;
+        const float* output_data = run_batch(&segment, 1);
         
         // Extract embedding
-        float* output_data = output_tensors[0].GetTensorMutableData<float>();
         std::vector<float> embedding(output_data, output_data + embedding_dim_);
         
         // Normalize embedding to unit length
@@ -123,6 +150,130 @@ std::vector<float> SpeakerEmbedder::extract_embedding(const std::vector<float>&
     }
 }
 
+float* SpeakerEmbedder::run_batch(const std::vector<float>* const* segments, size_t count) {
+    arena_.reset();
+    
+    float* batch_input = arena_.allocate<float>(count * target_length_);
+    for (size_t b = 0; b < count; b++) {
+        prepare_audio_segment(*segments[b], batch_input + b * target_length_);
+    }
+    
+    // FIXED: Create 2D input tensor for embedding model (batch_size, samples)
+    // The embedding model expects [batch, samples] not [batch, channels, samples]
+    const int64_t input_shape[] = {static_cast<int64_t>(count), static_cast<int64_t>(target_length_)};
+    const char* input_names[] = {input_name_.c_str()};
+    const char* output_names[] = {output_name_.c_str()};
+    
+    AllocationCounter::RuntimeScope runtime;
+    auto input_tensor = Ort::Value::CreateTensor<float>(
+        memory_info_, batch_input, count * target_length_, input_shape, 2);
+    
+    // With a static embedding shape the model writes straight into the arena
+    if (!output_shape_.empty()) {
+        float* output = arena_.allocate<float>(count * embedding_dim_);
+        output_shape_[0] = static_cast<int64_t>(count);
+        auto output_tensor = Ort::Value::CreateTensor<float>(
+            memory_info_, output, count * embedding_dim_, output_shape_.data(), output_shape_.size());
+        session_->Run(run_options_, input_names, &input_tensor, 1, output_names, &output_tensor, 1);
+        inference_count_++;
+        return output;
+    }
+    
+    auto output_tensors = session_->Run(run_options_,
+                                      input_names, &input_tensor, 1,
+                                      output_names, 1);
+    inference_count_++;
+    
+    const float* output_data = output_tensors[0].GetTensorMutableData<float>();
+    float* output = arena_.allocate<float>(count * embedding_dim_);
+    std::copy(output_data, output_data + count * embedding_dim_, output);
+    return output;
+}
+
+std::vector<std::vector<float>> SpeakerEmbedder::extract_embeddings(const std::vector<std::vector<float>>& audio_segments,
+                                                                    size_t batch_size) {
+    std::vector<std::vector<float>> embeddings;
+    embeddings.reserve(audio_segments.size());
+    
+    if (!is_initialized()) {
+        std::cerr << "❌ Embedder not initialized" << std::endl;
+        embeddings.assign(audio_segments.size(), std::vector<float>(embedding_dim_, 0.0f));
+        return embeddings;
+    }
+    
+    batch_size = std::max<size_t>(1, std::min(batch_size, max_batch_size_));
+    
+    std::vector<const std::vector<float>*> batch;
+    
+    for (size_t first = 0; first < audio_segments.size(); first += batch_size) {
+        const size_t count = std::min(batch_size, audio_segments.size() - first);
+        
+        // Cancelled: remaining segments get zero embeddings without touching the model
+        if (terminated_) {
+            embeddings.resize(first + count, std::vector<float>(embedding_dim_, 0.0f));
+            continue;
+        }
+        
+        try {
+            batch.clear();
+            for (size_t b = 0; b < count; b++) {
+                batch.push_back(&audio_segments[first + b]);
+            }
+            
+            const float* output_data = run_batch(batch.data(), count);
+            for (size_t b = 0; b < count; b++) {
+                std::vector<float> embedding(output_data + b * embedding_dim_,
+                                             output_data + (b + 1) * embedding_dim_);
+                normalize_embedding(embedding);
+                embeddings.push_back(std::move(embedding));
+            }
+            
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Batched embedding extraction failed: " << e.what() << std::endl;
+            while (embeddings.size() < first + count) {
+                embeddings.push_back(std::vector<float>(embedding_dim_, 0.0f));
+            }
+        }
+    }
+    
+    return embeddings;
+}
+
+std::vector<float> SpeakerEmbedder::extract_mean_embedding(const std::vector<std::vector<float>>& crops) {
+    std::vector<float> embedding(embedding_dim_, 0.0f);
+    
+    if (!is_initialized() || crops.empty() || terminated_) {
+        return embedding;
+    }
+    
+    std::vector<const std::vector<float>*> batch;
+    batch.reserve(crops.size());
+    for (const auto& crop : crops) {
+        batch.push_back(&crop);
+    }
+    
+    // Crops are summed in place in the arena, so no per-crop embedding is allocated
+    const size_t batch_size = std::min(crops.size(), max_batch_size_);
+    for (size_t first = 0; first < crops.size(); first += batch_size) {
+        const size_t count = std::min(batch_size, crops.size() - first);
+        try {
+            float* output_data = run_batch(batch.data() + first, count);
+            for (size_t b = 0; b < count; b++) {
+                float* crop_embedding = output_data + b * embedding_dim_;
+                normalize_embedding(crop_embedding, embedding_dim_);
+                for (size_t i = 0; i < embedding_dim_; i++) {
+                    embedding[i] += crop_embedding[i];
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Batched embedding extraction failed: " << e.what() << std::endl;
+        }
+    }
+    
+    normalize_embedding(embedding);
+    return embedding;
+}
+
 int SpeakerEmbedder::find_or_create_speaker(const std::vector<float>& embedding, float threshold, int max_speakers) {
     float best_similarity = -1.0f;
     int best_speaker = -1;
@@ -173,6 +324,59 @@ float SpeakerEmbedder::calculate_confidence(const std::vector<float>& embedding,
     return (similarity + 1.0f) / 2.0f; // Convert from [-1,1] to [0,1]
 }
 
+int SpeakerEmbedder::find_closest_speaker(const std::vector<float>& embedding) {
+    int best_speaker = -1;
+    float best_similarity = -2.0f;
+    
+    for (size_t i = 0; i < speaker_centroids_.size(); i++) {
+        float similarity = cosine_similarity(embedding, speaker_centroids_[i]);
+        if (similarity > best_similarity) {
+            best_similarity = similarity;
+            best_speaker = static_cast<int>(i);
+        }
+    }
+    
+    return best_speaker;
+}
+
+SpeakerMatch SpeakerEmbedder::match_speaker(const std::vector<float>& embedding) {
+    SpeakerMatch match;
+    
+    for (size_t i = 0; i < speaker_centroids_.size(); i++) {
+        if (speaker_centroids_[i].empty()) continue;
+        
+        float similarity = cosine_similarity(embedding, speaker_centroids_[i]);
+        if (similarity > match.similarity) {
+            match.runner_up = match.similarity;
+            match.similarity = similarity;
+            match.speaker_id = static_cast<int>(i);
+        } else if (similarity > match.runner_up) {
+            match.runner_up = similarity;
+        }
+    }
+    
+    return match;
+}
+
+void SpeakerEmbedder::add_to_speaker(int speaker_id, const std::vector<float>& embedding) {
+    if (speaker_id < 0) {
+        return;
+    }
+    
+    if (static_cast<size_t>(speaker_id) >= speaker_centroids_.size()) {
+        speaker_centroids_.resize(speaker_id + 1);
+        speaker_counts_.resize(speaker_id + 1, 0);
+    }
+    
+    if (speaker_centroids_[speaker_id].empty()) {
+        speaker_centroids_[speaker_id] = embedding;
+        speaker_counts_[speaker_id] = 1;
+        return;
+    }
+    
+    update_speaker_centroid(speaker_id, embedding);
+}
+
 void SpeakerEmbedder::reset_speakers() {
     speaker_centroids_.clear();
     speaker_counts_.clear();
@@ -183,21 +387,11 @@ void SpeakerEmbedder::reset_speakers() {
 }
 
 void SpeakerEmbedder::normalize_embedding(std::vector<float>& embedding) {
-    if (embedding.empty()) return;
-    
-    // Calculate L2 norm
-    float norm = 0.0f;
-    for (float val : embedding) {
-        norm += val * val;
-    }
-    norm = std::sqrt(norm);
-    
-    // Normalize if norm is significant
-    if (norm > 1e-6f) {
-        for (float& val : embedding) {
-            val /= norm;
-        }
-    }
+    normalize_embedding(embedding.data(), embedding.size());
+}
+
+void SpeakerEmbedder::normalize_embedding(float* embedding, size_t length) {
+    SimdKernels::normalize(embedding, length);
 }
 
 float SpeakerEmbedder::cosine_similarity(const std::vector<float>& a, const std::vector<float>& b) {
@@ -205,37 +399,24 @@ float SpeakerEmbedder::cosine_similarity(const std::vector<float>& a, const std:
         return 0.0f;
     }
     
-    float dot_product = 0.0f;
-    for (size_t i = 0; i < a.size(); i++) {
-        dot_product += a[i] * b[i];
-    }
-    
     // Assuming vectors are already normalized, dot product = cosine similarity
-    return std::max(-1.0f, std::min(1.0f, dot_product));
+    return std::max(-1.0f, std::min(1.0f, SimdKernels::dot(a.data(), b.data(), a.size())));
 }
 
 std::vector<float> SpeakerEmbedder::prepare_audio_segment(const std::vector<float>& audio) {
     std::vector<float> prepared(target_length_, 0.0f);
-    
-    // Copy audio data (pad with zeros if too short, truncate if too long)
-    size_t copy_length = std::min(audio.size(), target_length_);
-    std::copy(audio.begin(), audio.begin() + copy_length, prepared.begin());
-    
-    // Normalize audio
-    float max_val = 0.0f;
-    for (float sample : prepared) {
-        max_val = std::max(max_val, std::abs(sample));
-    }
-    
-    if (max_val > 1e-6f) {
-        for (float& sample : prepared) {
-            sample /= max_val;
-        }
-    }
-    
+    prepare_audio_segment(audio, prepared.data());
     return prepared;
 }
 
+void SpeakerEmbedder::prepare_audio_segment(const std::vector<float>& audio, float* output) {
+    // Copy audio data (pad with zeros if too short, truncate if too long), normalized in the copy
+    size_t copy_length = std::min(audio.size(), target_length_);
+    const float max_val = SimdKernels::max_abs(audio.data(), copy_length);
+    SimdKernels::gain_emphasis(output, audio.data(), max_val > 1e-6f ? 1.0f / max_val : 1.0f, 0.0f, copy_length);
+    std::fill(output + copy_length, output + target_length_, 0.0f);
+}
+
 void SpeakerEmbedder::update_speaker_centroid(int speaker_id, const std::vector<float>& embedding) {
     if (speaker_id < 0 || static_cast<size_t>(speaker_id) >= speaker_centroids_.size()) {
         return;
@@ -245,9 +426,10 @@ void SpeakerEmbedder::update_speaker_centroid(int speaker_id, const std::vector<
     int& count = speaker_counts_[speaker_id];
     
     // Update centroid using running average
-    for (size_t i = 0; i < embedding.size() && i < centroid.size(); i++) {
-        centroid[i] = (centroid[i] * count + embedding[i]) / (count + 1);
-    }
+    const size_t length = std::min(embedding.size(), centroid.size());
+    const float weight = 1.0f / (count + 1);
+    SimdKernels::scale(centroid.data(), count * weight, length);
+    SimdKernels::scaled_add(centroid.data(), embedding.data(), weight, length);
     
     count++;
     
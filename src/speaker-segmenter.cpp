@@ -1,22 +1,48 @@
 // src/native/diarization/speaker-segmenter.cpp - FIXED for Windows ONNX Runtime
 #include "speaker-segmenter.h"
 #include "utils.h"
+#include "execution-provider.h"
+#include "allocation-counter.h"
+#include "simd-kernels.h"
+#include "signal-filters.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
+namespace {
+
+constexpr float kPreEmphasis = 0.97f;  // Pre-emphasis coefficient of the model input
+
+// Zero padding after the copied samples; the first one still carries the emphasis of the last sample
+void pad_window(float* row, size_t copied, size_t window_size, float last_sample) {
+    if (copied < window_size) {
+        row[copied] = -kPreEmphasis * last_sample;
+        std::fill(row + copied + 1, row + window_size, 0.0f);
+    }
+}
+
+} // namespace
+
 SpeakerSegmenter::SpeakerSegmenter(bool verbose)
     : env_(ORT_LOGGING_LEVEL_WARNING, "speaker-segmenter"),
       memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)),
       verbose_(verbose),
       window_size_(51200),  // FIXED: Match pyannote model expectations (3.2s at 16kHz)
       hop_size_(25600),     // FIXED: 1.6s hop (50% overlap)
-      sample_rate_(16000) {
+      sample_rate_(16000),
+      max_batch_size_(1),
+      intra_op_threads_(4),
+      provider_("cpu"),
+      provider_used_("cpu"),
+      terminated_(false),
+      output_frames_(0),
+      output_classes_(0) {
     
     session_options_.SetIntraOpNumThreads(4);
     session_options_.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
@@ -27,7 +53,30 @@ SpeakerSegmenter::SpeakerSegmenter(bool verbose)
 
 SpeakerSegmenter::~SpeakerSegmenter() = default;
 
-bool SpeakerSegmenter::initialize(const std::string& model_path, int sample_rate) {
+void SpeakerSegmenter::set_intra_op_threads(int threads, bool allow_spinning) {
+    intra_op_threads_ = threads;
+    session_options_.SetIntraOpNumThreads(threads);
+    session_options_.AddConfigEntry("session.intra_op.allow_spinning", allow_spinning ? "1" : "0");
+}
+
+void SpeakerSegmenter::set_thread_affinities(const std::string& affinities) {
+    if (!affinities.empty()) {
+        session_options_.AddConfigEntry("session.intra_op_thread_affinities", affinities.c_str());
+    }
+}
+
+void SpeakerSegmenter::terminate() {
+    terminated_ = true;
+    run_options_.SetTerminate();
+}
+
+void SpeakerSegmenter::clear_terminate() {
+    run_options_.UnsetTerminate();
+    terminated_ = false;
+}
+
+bool SpeakerSegmenter::initialize(const std::string& model_path, int sample_rate,
+                                  float window_duration, float hop_duration) {
     try {
         if (verbose_) {
             std::cout << "Loading segmentation model: " << model_path << std::endl;
@@ -35,17 +84,25 @@ bool SpeakerSegmenter::initialize(const std::string& model_path, int sample_rate
         
         sample_rate_ = sample_rate;
         
-        // FIXED: Use exact window sizes that match pyannote models
-        window_size_ = 51200;  // Exactly what pyannote segmentation-3.0 expects
-        hop_size_ = 25600;     // 50% overlap
+        // Defaults match pyannote segmentation-3.0 (3.2s windows, 50% overlap)
+        window_size_ = static_cast<int>(window_duration * sample_rate);
+        hop_size_ = std::max(1, std::min(window_size_, static_cast<int>(hop_duration * sample_rate)));
         
-        // FIXED: Windows requires wstring for ONNX Runtime model path
-#ifdef _WIN32
-        auto wmodel_path = string_to_wstring(model_path);
-        session_ = std::make_unique<Ort::Session>(env_, wmodel_path.c_str(), session_options_);
-#else
-        session_ = std::make_unique<Ort::Session>(env_, model_path.c_str(), session_options_);
-#endif
+        session_ = ExecutionProvider::create_session(env_, model_path, session_options_, provider_,
+                                                     intra_op_threads_, provider_used_, verbose_);
+        
+        // A dynamic batch dimension (-1) lets us segment several windows per call
+        auto input_shape = session_->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (!input_shape.empty() && input_shape[0] > 0) {
+            max_batch_size_ = static_cast<size_t>(input_shape[0]);
+        } else {
+            max_batch_size_ = std::numeric_limits<size_t>::max();
+        }
+        
+        input_name_ = session_->GetInputNameAllocated(0, Ort::AllocatorWithDefaultOptions()).get();
+        output_name_ = session_->GetOutputNameAllocated(0, Ort::AllocatorWithDefaultOptions()).get();
+        output_frames_ = 0;
+        output_classes_ = 0;
         
         if (verbose_) {
             auto input_count = session_->GetInputCount();
@@ -56,6 +113,8 @@ bool SpeakerSegmenter::initialize(const std::string& model_path, int sample_rate
             std::cout << "  Outputs: " << output_count << std::endl;
             std::cout << "  Window size: " << window_size_ << " samples" << std::endl;
             std::cout << "  Hop size: " << hop_size_ << " samples" << std::endl;
+            std::cout << "  Batching: " << (max_batch_size_ > 1 ? "dynamic" : "fixed batch of 1") << std::endl;
+            std::cout << "  Provider: " << provider_used_ << std::endl;
         }
         
         return true;
@@ -66,13 +125,13 @@ bool SpeakerSegmenter::initialize(const std::string& model_path, int sample_rate
     }
 }
 
-std::vector<float> SpeakerSegmenter::detect_change_points(const std::vector<float>& audio, float threshold) {
+std::vector<int64_t> SpeakerSegmenter::detect_change_points(const AudioBuffer& audio, float threshold) {
     if (!is_initialized()) {
         std::cerr << "❌ Segmenter not initialized" << std::endl;
         return {};
     }
     
-    std::vector<float> change_points;
+    std::vector<int64_t> change_points;
     
     if (verbose_) {
         std::cout << "Detecting speaker changes in " << audio.size() << " samples..." << std::endl;
@@ -89,19 +148,22 @@ std::vector<float> SpeakerSegmenter::detect_change_points(const std::vector<floa
         
         size_t processed_windows = 0;
         std::vector<float> all_probabilities;
-        std::vector<float> all_timestamps;
+        std::vector<int64_t> all_frame_samples;
         
-        // Process audio with sliding window
+        // Process audio with sliding window, converting each window from int16 as it is read
+        std::vector<float> window(static_cast<size_t>(window_size_));
         for (size_t i = 0; i + window_size_ < audio.size(); i += hop_size_) {
-            std::vector<float> window(audio.begin() + i, audio.begin() + i + window_size_);
+            audio.read(i, window.size(), window.data());
             
             auto probabilities = process_window(window);
             
             // FIXED: Store all probabilities for global analysis
-            for (size_t j = 0; j < probabilities.size(); j++) {
-                float timestamp = static_cast<float>(i + j * (window_size_ / probabilities.size())) / sample_rate_;
+            // Frame starts are kept as exact sample indices; no float round trip
+            const int64_t window_start = static_cast<int64_t>(i);
+            const int64_t frame_count = static_cast<int64_t>(probabilities.size());
+            for (int64_t j = 0; j < frame_count; j++) {
                 all_probabilities.push_back(probabilities[j]);
-                all_timestamps.push_back(timestamp);
+                all_frame_samples.push_back(window_start + j * window_size_ / frame_count);
             }
             
             processed_windows++;
@@ -135,18 +197,14 @@ std::vector<float> SpeakerSegmenter::detect_change_points(const std::vector<floa
                 std::cout << "  Adaptive threshold: " << adaptive_threshold << std::endl;
             }
             
-            // Find change points using adaptive threshold
-            for (size_t i = 1; i < all_probabilities.size() - 1; i++) {
-                if (all_probabilities[i] > adaptive_threshold && 
-                    all_probabilities[i] > all_probabilities[i-1] && 
-                    all_probabilities[i] > all_probabilities[i+1]) {
-                    
-                    change_points.push_back(all_timestamps[i]);
-                    
-                    if (verbose_) {
-                        std::cout << "📍 Change point found at " << all_timestamps[i] 
-                                 << "s (prob: " << all_probabilities[i] << ")" << std::endl;
-                    }
+            // Find change points using adaptive threshold (local maxima of their neighbours)
+            for (size_t i : Signal::find_peaks(all_probabilities.data(), all_probabilities.size(), adaptive_threshold, 1)) {
+                change_points.push_back(all_frame_samples[i]);
+                
+                if (verbose_) {
+                    std::cout << "📍 Change point found at " 
+                             << static_cast<double>(all_frame_samples[i]) / sample_rate_
+                             << "s (prob: " << all_probabilities[i] << ")" << std::endl;
                 }
             }
         }
@@ -158,19 +216,23 @@ std::vector<float> SpeakerSegmenter::detect_change_points(const std::vector<floa
             }
             
             // Create segments every 30 seconds for long audio
-            float duration = static_cast<float>(audio.size()) / sample_rate_;
-            for (float t = 30.0f; t < duration - 10.0f; t += 30.0f) {
+            const int64_t total_samples = static_cast<int64_t>(audio.size());
+            const int64_t step = 30 * static_cast<int64_t>(sample_rate_);
+            const int64_t tail = 10 * static_cast<int64_t>(sample_rate_);
+            for (int64_t t = step; t < total_samples - tail; t += step) {
                 change_points.push_back(t);
                 if (verbose_) {
-                    std::cout << "📍 Artificial change point at " << t << "s" << std::endl;
+                    std::cout << "📍 Artificial change point at " 
+                             << static_cast<double>(t) / sample_rate_ << "s" << std::endl;
                 }
             }
         }
         
         // Remove duplicates and sort
         std::sort(change_points.begin(), change_points.end());
+        const int64_t min_gap = sample_rate_;  // 1 second
         auto last = std::unique(change_points.begin(), change_points.end(), 
-                               [](float a, float b) { return std::abs(a - b) < 1.0f; });
+                               [min_gap](int64_t a, int64_t b) { return std::abs(a - b) < min_gap; });
         change_points.erase(last, change_points.end());
         
         if (verbose_) {
@@ -185,54 +247,274 @@ std::vector<float> SpeakerSegmenter::detect_change_points(const std::vector<floa
     }
 }
 
-std::vector<float> SpeakerSegmenter::process_window(const std::vector<float>& audio_window) {
+bool SpeakerSegmenter::run_model(const std::vector<float>& audio_window,
+                                 std::vector<float>& logits,
+                                 size_t& time_steps,
+                                 size_t& num_classes) {
+    const float* window = audio_window.data();
+    const size_t length = audio_window.size();
+    const float* output = run_batch(&window, &length, 1, time_steps, num_classes);
+    if (!output) {
+        return false;
+    }
+    logits.assign(output, output + time_steps * num_classes);
+    return true;
+}
+
+const float* SpeakerSegmenter::run_batch(const float* const* windows,
+                                         const size_t* lengths,
+                                         size_t count,
+                                         size_t& time_steps,
+                                         size_t& num_classes) {
+    const size_t window_size = static_cast<size_t>(window_size_);
+    arena_.reset();
+    
+    // FIXED: Ensure exact window size (zero-padded), each window normalized to a peak of 1 on its own
+    // Gain and pre-emphasis (helps with some models) are applied in the copy itself
+    float* batch_input = arena_.allocate<float>(count * window_size);
+    for (size_t b = 0; b < count; b++) {
+        float* row = batch_input + b * window_size;
+        const size_t copied = std::min(lengths[b], window_size);
+        const float max_val = SimdKernels::max_abs(windows[b], copied);
+        const float gain = max_val > 1e-6f ? 1.0f / max_val : 1.0f;
+        SimdKernels::gain_emphasis(row, windows[b], gain, kPreEmphasis, copied);
+        pad_window(row, copied, window_size, copied > 0 ? windows[b][copied - 1] * gain : 0.0f);
+    }
+    
+    return run_input(batch_input, count, time_steps, num_classes);
+}
+
+const float* SpeakerSegmenter::run_batch(const AudioBuffer& audio,
+                                         const AudioGain& gain,
+                                         const int64_t* start_samples,
+                                         size_t count,
+                                         size_t& time_steps,
+                                         size_t& num_classes) {
+    const size_t window_size = static_cast<size_t>(window_size_);
+    arena_.reset();
+    
+    // int16 samples are converted, scaled and pre-emphasized in a single pass into the input
+    float* batch_input = arena_.allocate<float>(count * window_size);
+    for (size_t b = 0; b < count; b++) {
+        float* row = batch_input + b * window_size;
+        const size_t start = static_cast<size_t>(start_samples[b]);
+        const float window_gain = gain.gain(start, start + window_size);
+        const size_t copied = audio.read(start, window_size, row, window_gain, kPreEmphasis);
+        pad_window(row, copied, window_size, copied > 0 ? audio[start + copied - 1] * window_gain : 0.0f);
+    }
+    
+    return run_input(batch_input, count, time_steps, num_classes);
+}
+
+const float* SpeakerSegmenter::run_input(float* batch_input,
+                                         size_t count,
+                                         size_t& time_steps,
+                                         size_t& num_classes) {
+    const size_t window_size = static_cast<size_t>(window_size_);
+    if (terminated_) {
+        return nullptr;
+    }
+    
+    // FIXED: Use correct 3D input shape for pyannote segmentation model [batch, channels, samples]
+    const int64_t input_shape[] = {static_cast<int64_t>(count), 1, static_cast<int64_t>(window_size_)};
+    const char* input_names[] = {input_name_.c_str()};
+    const char* output_names[] = {output_name_.c_str()};
+    
+    AllocationCounter::RuntimeScope runtime;
+    auto input_tensor = Ort::Value::CreateTensor<float>(
+        memory_info_, batch_input, count * window_size, input_shape, 3);
+    
+    // Once the output shape is known the model writes straight into the arena
+    if (output_frames_ > 0) {
+        const size_t output_size = count * output_frames_ * output_classes_;
+        float* logits = arena_.allocate<float>(output_size);
+        const int64_t output_shape[] = {static_cast<int64_t>(count), static_cast<int64_t>(output_frames_), 
+                                        static_cast<int64_t>(output_classes_)};
+        auto output_tensor = Ort::Value::CreateTensor<float>(memory_info_, logits, output_size, output_shape, 3);
+        session_->Run(run_options_, input_names, &input_tensor, 1, output_names, &output_tensor, 1);
+        
+        time_steps = output_frames_;
+        num_classes = output_classes_;
+        return logits;
+    }
+    
+    auto output_tensors = session_->Run(run_options_,
+                                      input_names, &input_tensor, 1,
+                                      output_names, 1);
+    
+    const float* output_data = output_tensors[0].GetTensorMutableData<float>();
+    auto output_shape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
+    
+    if (output_shape.size() != 3 || static_cast<size_t>(output_shape[0]) != count) {
+        std::cerr << "❌ Unexpected segmentation output shape (rank " << output_shape.size() << ")" << std::endl;
+        return nullptr;
+    }
+    
+    time_steps = static_cast<size_t>(output_shape[1]);   // Should be 186 for pyannote
+    num_classes = static_cast<size_t>(output_shape[2]);  // Should be 7 for pyannote (powerset classes)
+    output_frames_ = time_steps;
+    output_classes_ = num_classes;
+    
+    float* logits = arena_.allocate<float>(count * time_steps * num_classes);
+    std::copy(output_data, output_data + count * time_steps * num_classes, logits);
+    return logits;
+}
+
+WindowActivity SpeakerSegmenter::process_window_activity(const std::vector<float>& audio_window, int64_t start_sample) {
+    WindowActivity result;
+    result.start_sample = start_sample;
+    
     if (!is_initialized()) {
-        return {};
+        return result;
     }
     
     try {
-        // FIXED: Ensure exact window size
-        std::vector<float> window = audio_window;
-        if (window.size() != static_cast<size_t>(window_size_)) {
-            window.resize(window_size_, 0.0f);
-            if (audio_window.size() < static_cast<size_t>(window_size_)) {
-                std::copy(audio_window.begin(), audio_window.end(), window.begin());
-            }
+        std::vector<float> logits;
+        size_t time_steps = 0;
+        size_t num_classes = 0;
+        if (!run_model(audio_window, logits, time_steps, num_classes)) {
+            return result;
         }
         
-        normalize_audio(window);
+        if (num_classes != decoder_.num_classes()) {
+            std::cerr << "❌ Segmentation model has " << num_classes << " output classes, expected "
+                     << decoder_.num_classes() << " powerset classes" << std::endl;
+            return result;
+        }
         
-        auto input_name = session_->GetInputNameAllocated(0, Ort::AllocatorWithDefaultOptions());
-        auto output_name = session_->GetOutputNameAllocated(0, Ort::AllocatorWithDefaultOptions());
+        result.num_frames = time_steps;
+        result.num_speakers = decoder_.num_speakers();
+        result.activity.resize(time_steps * result.num_speakers);
+        decoder_.decode(logits.data(), time_steps, result.activity.data());
         
-        // FIXED: Use correct 3D input shape for pyannote segmentation model [batch, channels, samples]
-        std::vector<int64_t> input_shape = {1, 1, static_cast<int64_t>(window_size_)};
-        auto input_tensor = Ort::Value::CreateTensor<float>(
-            memory_info_, window.data(), window.size(), 
-            input_shape.data(), input_shape.size());
+        return result;
         
-        std::vector<const char*> input_names = {input_name.get()};
-        std::vector<const char*> output_names = {output_name.get()};
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Window processing failed: " << e.what() << std::endl;
+        return result;
+    }
+}
+
+bool SpeakerSegmenter::decode_batch(const float* logits, size_t time_steps, size_t num_classes,
+                                    WindowActivity* results, size_t count) {
+    if (num_classes != decoder_.num_classes()) {
+        std::cerr << "❌ Segmentation model has " << num_classes << " output classes, expected "
+                 << decoder_.num_classes() << " powerset classes" << std::endl;
+        return false;
+    }
+    
+    for (size_t b = 0; b < count; b++) {
+        auto& result = results[b];
+        result.num_frames = time_steps;
+        result.num_speakers = decoder_.num_speakers();
+        result.activity.resize(time_steps * result.num_speakers);
+        decoder_.decode(logits + b * time_steps * num_classes, time_steps, result.activity.data());
+    }
+    return true;
+}
+
+std::vector<WindowActivity> SpeakerSegmenter::process_windows_activity(const std::vector<std::vector<float>>& audio_windows,
+                                                                      const std::vector<int64_t>& start_samples,
+                                                                      size_t batch_size) {
+    std::vector<WindowActivity> results(audio_windows.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        results[i].start_sample = start_samples[i];
+    }
+    
+    if (!is_initialized()) {
+        return results;
+    }
+    
+    batch_size = std::max<size_t>(1, std::min(batch_size, max_batch_size_));
+    
+    for (size_t first = 0; first < audio_windows.size(); first += batch_size) {
+        const size_t count = std::min(batch_size, audio_windows.size() - first);
         
-        auto output_tensors = session_->Run(Ort::RunOptions{nullptr},
-                                          input_names.data(), &input_tensor, 1,
-                                          output_names.data(), 1);
+        try {
+            batch_windows_.clear();
+            batch_lengths_.clear();
+            for (size_t b = 0; b < count; b++) {
+                batch_windows_.push_back(audio_windows[first + b].data());
+                batch_lengths_.push_back(audio_windows[first + b].size());
+            }
+            
+            size_t time_steps = 0;
+            size_t num_classes = 0;
+            const float* logits = run_batch(batch_windows_.data(), batch_lengths_.data(), count, time_steps, num_classes);
+            if (!logits) {
+                continue;
+            }
+            if (!decode_batch(logits, time_steps, num_classes, results.data() + first, count)) {
+                return results;
+            }
+            
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Batched window processing failed: " << e.what() << std::endl;
+        }
+    }
+    
+    return results;
+}
+
+void SpeakerSegmenter::process_windows_activity(const AudioBuffer& audio,
+                                                const AudioGain& gain,
+                                                const std::vector<int64_t>& start_samples,
+                                                size_t batch_size,
+                                                std::vector<WindowActivity>& results) {
+    // Entries are reused, so failed windows must not keep an earlier call's activity
+    results.resize(start_samples.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        results[i].start_sample = start_samples[i];
+        results[i].num_frames = 0;
+        results[i].num_speakers = 0;
+        results[i].activity.clear();
+    }
+    
+    if (!is_initialized()) {
+        return;
+    }
+    
+    batch_size = std::max<size_t>(1, std::min(batch_size, max_batch_size_));
+    
+    for (size_t first = 0; first < start_samples.size(); first += batch_size) {
+        const size_t count = std::min(batch_size, start_samples.size() - first);
         
-        float* output_data = output_tensors[0].GetTensorMutableData<float>();
-        auto output_shape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
+        try {
+            size_t time_steps = 0;
+            size_t num_classes = 0;
+            const float* logits = run_batch(audio, gain, start_samples.data() + first, count, time_steps, num_classes);
+            if (!logits) {
+                continue;
+            }
+            if (!decode_batch(logits, time_steps, num_classes, results.data() + first, count)) {
+                return;
+            }
+            
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Batched window processing failed: " << e.what() << std::endl;
+        }
+    }
+}
+
+std::vector<float> SpeakerSegmenter::process_window(const std::vector<float>& audio_window) {
+    if (!is_initialized()) {
+        return {};
+    }
+    
+    try {
+        std::vector<float> logits;
+        size_t time_steps = 0;
+        size_t num_classes = 0;
+        if (!run_model(audio_window, logits, time_steps, num_classes)) {
+            return {};
+        }
+        const float* output_data = logits.data();
         
         if (verbose_) {
-            std::cout << "Model output shape: ";
-            for (auto dim : output_shape) {
-                std::cout << dim << " ";
-            }
-            std::cout << std::endl;
+            std::cout << "Model output shape: 1 " << time_steps << " " << num_classes << std::endl;
         }
         
         // FIXED: Better interpretation of pyannote segmentation output
-        size_t time_steps = output_shape[1];  // Should be 186 for pyannote
-        size_t num_classes = output_shape[2]; // Should be 7 for pyannote (speakers + silence)
-        
         std::vector<float> change_probabilities;
         change_probabilities.reserve(time_steps);
         
@@ -303,61 +585,3 @@ std::vector<float> SpeakerSegmenter::process_window(const std::vector<float>& au
         return {};
     }
 }
-
-void SpeakerSegmenter::normalize_audio(std::vector<float>& audio) {
-    if (audio.empty()) return;
-    
-    // FIXED: Better normalization for pyannote models
-    float max_val = 0.0f;
-    for (float sample : audio) {
-        max_val = std::max(max_val, std::abs(sample));
-    }
-    
-    if (max_val > 1e-6f) {
-        // Normalize to [-1, 1] range
-        for (float& sample : audio) {
-            sample /= max_val;
-        }
-    }
-    
-    // Optional: Apply pre-emphasis filter (helps with some models)
-    for (size_t i = audio.size() - 1; i > 0; i--) {
-        audio[i] = audio[i] - 0.97f * audio[i-1];
-    }
-}
-
-std::vector<float> SpeakerSegmenter::find_peaks(const std::vector<float>& probabilities, 
-                                               float threshold, 
-                                               size_t window_start_sample,
-                                               int samples_per_frame) {
-    std::vector<float> peaks;
-    
-    if (probabilities.size() < 3) {
-        return peaks;
-    }
-    
-    // FIXED: Much more aggressive peak finding
-    float max_prob = *std::max_element(probabilities.begin(), probabilities.end());
-    float adaptive_threshold = std::max(0.001f, std::min(threshold, max_prob * 0.3f));
-    
-    if (verbose_) {
-        std::cout << "Finding peaks with threshold: " << adaptive_threshold << std::endl;
-        std::cout << "Max probability in window: " << max_prob << std::endl;
-    }
-    
-    for (size_t i = 1; i < probabilities.size() - 1; i++) {
-        if (probabilities[i] > adaptive_threshold && 
-            probabilities[i] > probabilities[i-1] && 
-            probabilities[i] > probabilities[i+1]) {
-            
-            float time_point = static_cast<float>(window_start_sample + i * samples_per_frame) / sample_rate_;
-            peaks.push_back(time_point);
-            
-            if (verbose_) {
-                std::cout << "Found peak at time " << time_point << " with probability " << probabilities[i] << std::endl;
-            }
-        }
-    }
-    
-    return peaks;
-}
\ No newline at end of file
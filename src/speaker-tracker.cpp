@@ -0,0 +1,195 @@
+// src/native/diarization/speaker-tracker.cpp
+#include "speaker-tracker.h"
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+SpeakerTracker::SpeakerTracker(int64_t window_size, float link_threshold, float activity_threshold, bool verbose)
+    : window_size_(window_size),
+      link_threshold_(link_threshold),
+      activity_threshold_(activity_threshold),
+      verbose_(verbose),
+      frames_per_window_(0),
+      has_previous_(false),
+      previous_offset_(0),
+      link_count_(0) {
+}
+
+void SpeakerTracker::reset() {
+    frames_per_window_ = 0;
+    tracks_.clear();
+    has_previous_ = false;
+    previous_offset_ = 0;
+    previous_ = WindowActivity();
+    previous_track_ids_.clear();
+    link_count_ = 0;
+}
+
+int64_t SpeakerTracker::frame_to_sample(int64_t frame) const {
+    if (frames_per_window_ == 0) return 0;
+    return frame * window_size_ / static_cast<int64_t>(frames_per_window_);
+}
+
+int64_t SpeakerTracker::sample_to_frame(int64_t sample) const {
+    if (frames_per_window_ == 0) return 0;
+    return (sample * static_cast<int64_t>(frames_per_window_) + window_size_ / 2) / window_size_;
+}
+
+void SpeakerTracker::add_window(const WindowActivity& window) {
+    if (window.num_frames == 0 || window.num_speakers == 0) {
+        return;
+    }
+
+    if (frames_per_window_ == 0) {
+        frames_per_window_ = window.num_frames;
+    } else if (window.num_frames != frames_per_window_) {
+        std::cerr << "❌ Window has " << window.num_frames << " frames, expected "
+                 << frames_per_window_ << std::endl;
+        return;
+    }
+
+    const size_t speakers = window.num_speakers;
+    const int64_t offset = sample_to_frame(window.start_sample);
+
+    // A local speaker is present if it is confidently active somewhere in the window
+    auto& present = present_;
+    present.assign(speakers, false);
+    for (size_t t = 0; t < window.num_frames; t++) {
+        for (size_t s = 0; s < speakers; s++) {
+            if (window.at(t, s) >= activity_threshold_) {
+                present[s] = true;
+            }
+        }
+    }
+
+    auto& track_ids = track_ids_;
+    track_ids.assign(speakers, -1);
+
+    if (has_previous_ && previous_.num_speakers == speakers) {
+        const int64_t overlap_start = offset;
+        const int64_t overlap_end = previous_offset_ + static_cast<int64_t>(frames_per_window_);
+
+        if (overlap_end > overlap_start) {
+            // Score every (previous, current) pair on the overlap region
+            auto& scores = scores_;
+            scores.assign(speakers * speakers, 0.0f);
+            for (size_t a = 0; a < speakers; a++) {
+                if (previous_track_ids_[a] < 0) continue;
+                for (size_t b = 0; b < speakers; b++) {
+                    if (!present[b]) continue;
+                    scores[a * speakers + b] = overlap_correlation(previous_, a, window, b,
+                                                                   overlap_start, overlap_end,
+                                                                   previous_offset_, offset);
+                }
+            }
+
+            // Exhaustive permutation search; local speaker counts are tiny (3 for segmentation-3.0)
+            auto& perm = perm_;
+            auto& best_perm = best_perm_;
+            perm.resize(speakers);
+            std::iota(perm.begin(), perm.end(), 0);
+            best_perm = perm;
+            float best_total = -1.0f;
+            do {
+                float total = 0.0f;
+                for (size_t a = 0; a < speakers; a++) {
+                    float score = scores[a * speakers + perm[a]];
+                    if (score >= link_threshold_) {
+                        total += score;
+                    }
+                }
+                if (total > best_total) {
+                    best_total = total;
+                    best_perm = perm;
+                }
+            } while (std::next_permutation(perm.begin(), perm.end()));
+
+            for (size_t a = 0; a < speakers; a++) {
+                size_t b = best_perm[a];
+                if (previous_track_ids_[a] >= 0 && present[b] && scores[a * speakers + b] >= link_threshold_) {
+                    track_ids[b] = previous_track_ids_[a];
+                    link_count_++;
+                }
+            }
+        }
+    }
+
+    // Unlinked present speakers start new tracks
+    for (size_t s = 0; s < speakers; s++) {
+        if (present[s] && track_ids[s] < 0) {
+            SpeakerTrack track;
+            track.id = static_cast<int>(tracks_.size());
+            track.first_frame = offset;
+            tracks_.push_back(std::move(track));
+            track_ids[s] = tracks_.back().id;
+        }
+    }
+
+    for (size_t s = 0; s < speakers; s++) {
+        if (track_ids[s] >= 0) {
+            accumulate(tracks_[track_ids[s]], window, s, offset);
+        }
+    }
+
+    // Local speakers of one window are distinct people by construction
+    for (size_t a = 0; a < speakers; a++) {
+        for (size_t b = a + 1; b < speakers; b++) {
+            int ta = track_ids[a];
+            int tb = track_ids[b];
+            if (ta < 0 || tb < 0 || ta == tb) continue;
+
+            auto& conflicts_a = tracks_[ta].conflicts;
+            if (std::find(conflicts_a.begin(), conflicts_a.end(), tb) == conflicts_a.end()) {
+                conflicts_a.push_back(tb);
+                tracks_[tb].conflicts.push_back(ta);
+            }
+        }
+    }
+
+    previous_ = window;
+    previous_offset_ = offset;
+    previous_track_ids_ = track_ids;
+    has_previous_ = true;
+}
+
+float SpeakerTracker::overlap_correlation(const WindowActivity& prev, size_t prev_speaker,
+                                          const WindowActivity& cur, size_t cur_speaker,
+                                          int64_t overlap_start, int64_t overlap_end,
+                                          int64_t prev_offset, int64_t cur_offset) const {
+    float dot = 0.0f;
+    float prev_norm = 0.0f;
+    float cur_norm = 0.0f;
+
+    for (int64_t g = overlap_start; g < overlap_end; g++) {
+        float x = prev.at(static_cast<size_t>(g - prev_offset), prev_speaker);
+        float y = cur.at(static_cast<size_t>(g - cur_offset), cur_speaker);
+        dot += x * y;
+        prev_norm += x * x;
+        cur_norm += y * y;
+    }
+
+    // Silent on the overlap: nothing to correlate, leave it to the embedding model
+    if (prev_norm < 1e-6f || cur_norm < 1e-6f) {
+        return 0.0f;
+    }
+
+    return dot / std::sqrt(prev_norm * cur_norm);
+}
+
+void SpeakerTracker::accumulate(SpeakerTrack& track, const WindowActivity& window, size_t speaker, int64_t offset) {
+    const int64_t window_end = offset + static_cast<int64_t>(window.num_frames);
+    if (window_end > track.end_frame()) {
+        size_t new_size = static_cast<size_t>(window_end - track.first_frame);
+        track.activity_sum.resize(new_size, 0.0f);
+        track.coverage.resize(new_size, 0);
+    }
+
+    for (size_t t = 0; t < window.num_frames; t++) {
+        size_t i = static_cast<size_t>(offset - track.first_frame) + t;
+        track.activity_sum[i] += window.at(t, speaker);
+        track.coverage[i]++;
+    }
+
+    track.window_count++;
+}
@@ -0,0 +1,312 @@
+// src/native/diarization/spool-worker.cpp
+#include "spool-worker.h"
+#include "utils.h"
+#include "audio-buffer.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Files still being written by the producer are skipped
+bool is_job_file(const fs::directory_entry& entry) {
+    std::error_code ec;
+    if (!entry.is_regular_file(ec)) return false;
+    
+    const std::string name = entry.path().filename().string();
+    auto ends_with = [&name](const std::string& suffix) {
+        return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    return !name.empty() && name[0] != '.' && !ends_with(".tmp") && !ends_with(".part");
+}
+
+int64_t unix_seconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Write a small text file under its final name only once it is complete
+bool publish_text(const std::string& path, const std::string& text) {
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::trunc);
+        out << text;
+        if (!out) return false;
+    }
+    std::error_code ec;
+    fs::rename(temp_path, path, ec);
+    return !ec;
+}
+
+} // namespace
+
+std::atomic<bool> SpoolWorker::stop_requested_(false);
+
+SpoolWorker::SpoolWorker(DiarizationEngine& engine, const DiarizeOptions& options)
+    : engine_(engine),
+      options_(options),
+      spool_dir_(options.spool_dir),
+      worker_id_(options.worker_id.empty() ? default_worker_id() : options.worker_id),
+      lease_seconds_(std::max(1.0f, options.spool_lease)),
+      verbose_(options.verbose),
+      jobs_done_(0),
+      jobs_failed_(0),
+      inotify_fd_(-1) {
+    // '@' separates the fields of a lease name
+    std::replace(worker_id_.begin(), worker_id_.end(), '@', '_');
+    std::replace(worker_id_.begin(), worker_id_.end(), '/', '_');
+}
+
+std::string SpoolWorker::default_worker_id() {
+#ifdef _WIN32
+    const char* host = std::getenv("COMPUTERNAME");
+    return std::string(host ? host : "localhost") + "-" + std::to_string(_getpid());
+#else
+    char host[256] = {0};
+    if (gethostname(host, sizeof(host) - 1) != 0) {
+        host[0] = '\0';
+    }
+    return std::string(host[0] ? host : "localhost") + "-" + std::to_string(getpid());
+#endif
+}
+
+bool SpoolWorker::prepare_directories() {
+    for (const char* name : {"incoming", "leased", "done", "failed"}) {
+        std::error_code ec;
+        fs::create_directories(dir(name), ec);
+        if (ec) {
+            std::cerr << "❌ Cannot create spool directory " << dir(name) << ": " << ec.message() << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int SpoolWorker::run() {
+    if (!prepare_directories()) {
+        return 1;
+    }
+
+#ifdef __linux__
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ >= 0 && inotify_add_watch(inotify_fd_, dir("incoming").c_str(), IN_MOVED_TO | IN_CLOSE_WRITE) < 0) {
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+#endif
+    
+    if (verbose_) {
+        std::cout << "📬 Worker " << worker_id_ << " serving " << spool_dir_ 
+                 << (inotify_fd_ >= 0 ? " (inotify)" : " (polling)") << std::endl;
+    }
+    
+    // Stale leases are checked a few times per lease period, and on every idle wakeup
+    const int idle_timeout_ms = static_cast<int>(std::min(5.0, lease_seconds_ / 4.0) * 1000.0);
+    auto last_recovery = std::chrono::steady_clock::time_point();
+    
+    while (!stop_requested_) {
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - last_recovery).count() >= lease_seconds_ / 4.0) {
+            recover_stale_leases();
+            last_recovery = now;
+        }
+        
+        std::string name;
+        std::string lease_path;
+        if (claim_job(name, lease_path)) {
+            process_job(name, lease_path);
+            continue;
+        }
+        
+        wait_for_jobs(idle_timeout_ms);
+    }
+
+#ifdef __linux__
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+#endif
+    
+    if (verbose_) {
+        std::cout << "👋 Worker " << worker_id_ << " stopping: " << jobs_done_ << " jobs done, "
+                 << jobs_failed_ << " failed" << std::endl;
+    }
+    return 0;
+}
+
+void SpoolWorker::wait_for_jobs(int timeout_ms) {
+#ifdef __linux__
+    if (inotify_fd_ >= 0) {
+        pollfd pfd = {inotify_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, timeout_ms) > 0) {
+            // Drain the events; the directory is rescanned anyway
+            char buffer[4096];
+            while (read(inotify_fd_, buffer, sizeof(buffer)) > 0) {
+            }
+        }
+        return;
+    }
+#endif
+    std::this_thread::sleep_for(std::chrono::milliseconds(std::min(timeout_ms, 1000)));
+}
+
+bool SpoolWorker::claim_job(std::string& name, std::string& lease_path) {
+    std::error_code ec;
+    std::vector<std::pair<fs::file_time_type, std::string>> candidates;
+    for (const auto& entry : fs::directory_iterator(dir("incoming"), ec)) {
+        if (is_job_file(entry)) {
+            candidates.emplace_back(entry.last_write_time(ec), entry.path().filename().string());
+        }
+    }
+    
+    // Oldest first
+    std::sort(candidates.begin(), candidates.end());
+    
+    for (const auto& candidate : candidates) {
+        const std::string lease_name = candidate.second + "@" + worker_id_ + "@" + std::to_string(unix_seconds());
+        const std::string lease = dir("leased") + "/" + lease_name;
+        
+        // rename() is atomic: of all workers trying, exactly one succeeds
+        fs::rename(dir("incoming") + "/" + candidate.second, lease, ec);
+        if (ec) {
+            continue;
+        }
+        
+        fs::last_write_time(lease, fs::file_time_type::clock::now(), ec);
+        name = candidate.second;
+        lease_path = lease;
+        return true;
+    }
+    
+    return false;
+}
+
+void SpoolWorker::recover_stale_leases() {
+    std::error_code ec;
+    const auto file_now = fs::file_time_type::clock::now();
+    const int64_t now = unix_seconds();
+    
+    for (const auto& entry : fs::directory_iterator(dir("leased"), ec)) {
+        const std::string lease_name = entry.path().filename().string();
+        size_t time_sep = lease_name.rfind('@');
+        size_t worker_sep = time_sep == std::string::npos ? std::string::npos : lease_name.rfind('@', time_sep - 1);
+        if (worker_sep == std::string::npos || worker_sep == 0) continue;
+        
+        // Stale when both the claim and the last heartbeat are older than the lease
+        int64_t claimed = std::atoll(lease_name.c_str() + time_sep + 1);
+        double heartbeat_age = std::chrono::duration<double>(file_now - entry.last_write_time(ec)).count();
+        if (ec || now - claimed <= lease_seconds_ || heartbeat_age <= lease_seconds_) continue;
+        
+        const std::string name = lease_name.substr(0, worker_sep);
+        fs::rename(entry.path(), dir("incoming") + "/" + name, ec);
+        if (!ec) {
+            std::cout << "♻️ Recovered stale lease of " << lease_name.substr(worker_sep + 1, time_sep - worker_sep - 1)
+                     << ": " << name << std::endl;
+        }
+    }
+}
+
+void SpoolWorker::process_job(const std::string& name, const std::string& lease_path) {
+    const auto started = std::chrono::steady_clock::now();
+    if (verbose_) {
+        std::cout << "🎬 Claimed " << name << std::endl;
+    }
+    
+    // Heartbeat: keep the lease fresh while the models run
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool finished = false;
+    std::thread heartbeat([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        const auto period = std::chrono::duration<double>(lease_seconds_ / 3.0);
+        while (!cv.wait_for(lock, period, [&finished] { return finished; })) {
+            std::error_code ec;
+            fs::last_write_time(lease_path, fs::file_time_type::clock::now(), ec);
+        }
+    });
+    
+    std::string error;
+    std::vector<AudioSegment> segments;
+    DiarizeOptions options = options_;
+    options.audio_path = name;
+    options.output_file = dir("done") + "/" + name + ".json.tmp";
+    
+    try {
+        engine_.pin_to_segmentation_cores();
+        engine_.reset_profile();
+        engine_.begin_profile_stage("audio_load");
+        auto audio = Utils::Audio::load_audio_buffer(lease_path, options.sample_rate);
+        if (audio.empty()) {
+            error = "failed to load audio";
+        } else {
+            segments = engine_.process_audio(audio, options);
+            Utils::Json::output_results(segments, options, engine_.get_stats());
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    engine_.end_profile_stage();
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    cv.notify_one();
+    heartbeat.join();
+    
+    std::error_code ec;
+    const std::string result_path = dir("done") + "/" + name + ".json";
+    if (error.empty()) {
+        fs::rename(options.output_file, result_path, ec);
+        if (ec) {
+            error = "failed to publish result: " + ec.message();
+        }
+    }
+    
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    
+    if (!error.empty()) {
+        jobs_failed_++;
+        std::cerr << "❌ Job " << name << " failed: " << error << std::endl;
+        fs::remove(options.output_file, ec);
+        fs::rename(lease_path, dir("failed") + "/" + name, ec);
+        publish_text(dir("failed") + "/" + name + ".error", error + "\n");
+        return;
+    }
+    
+    // The lease may have been recovered by another worker if this one stalled; the result still stands
+    fs::rename(lease_path, dir("done") + "/" + name, ec);
+    if (ec) {
+        std::cout << "⚠️ Lease of " << name << " was lost while processing" << std::endl;
+    }
+    
+    // The marker is written last: its presence means the result is complete
+    publish_text(dir("done") + "/" + name + ".done",
+                 "worker=" + worker_id_ + "\nsegments=" + std::to_string(segments.size()) +
+                 "\nseconds=" + std::to_string(seconds) + "\n");
+    jobs_done_++;
+    
+    if (verbose_) {
+        std::cout << "✅ Finished " << name << " in " << seconds << "s (" << segments.size() << " segments)" << std::endl;
+    }
+}
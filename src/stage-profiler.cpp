@@ -0,0 +1,148 @@
+// src/native/diarization/stage-profiler.cpp
+#include "stage-profiler.h"
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+StageProfiler::StageProfiler() : current_(-1), current_unit_(-1) {
+}
+
+void StageProfiler::begin(const std::string& stage) {
+    end();
+    
+    for (size_t i = 0; i < stages_.size(); i++) {
+        if (stages_[i].name == stage) {
+            current_ = static_cast<int>(i);
+        }
+    }
+    if (current_ < 0) {
+        stages_.push_back({stage, 0.0, 0, 0, 0, 0});
+        current_ = static_cast<int>(stages_.size() - 1);
+    }
+    stages_[current_].count++;
+    allocations_ = AllocationCounter::snapshot();
+    started_ = Clock::now();
+}
+
+void StageProfiler::end() {
+    if (current_ < 0) {
+        return;
+    }
+    stages_[current_].seconds += std::chrono::duration<double>(Clock::now() - started_).count();
+    const auto allocations = AllocationCounter::snapshot();
+    stages_[current_].allocations += allocations.allocations - allocations_.allocations;
+    stages_[current_].bytes += allocations.bytes - allocations_.bytes;
+    stages_[current_].runtime_allocations += allocations.runtime_allocations - allocations_.runtime_allocations;
+    current_ = -1;
+}
+
+void StageProfiler::reset() {
+    stages_.clear();
+    units_.clear();
+    current_ = -1;
+    current_unit_ = -1;
+}
+
+void StageProfiler::begin_unit(const char* unit) {
+    end_unit();
+    
+    for (size_t i = 0; i < units_.size(); i++) {
+        if (units_[i].name == unit) {
+            current_unit_ = static_cast<int>(i);
+        }
+    }
+    if (current_unit_ < 0) {
+        units_.push_back({unit, 0, 0, 0, 0, 0});
+        current_unit_ = static_cast<int>(units_.size() - 1);
+    }
+    unit_allocations_ = AllocationCounter::snapshot();
+}
+
+void StageProfiler::end_unit() {
+    if (current_unit_ < 0) {
+        return;
+    }
+    const auto allocations = AllocationCounter::snapshot();
+    const uint64_t count = allocations.allocations - unit_allocations_.allocations;
+    const uint64_t bytes = allocations.bytes - unit_allocations_.bytes;
+    
+    auto& unit = units_[current_unit_];
+    if (unit.count > 0) {
+        unit.peak_allocations = std::max(unit.peak_allocations, count);
+        unit.peak_bytes = std::max(unit.peak_bytes, bytes);
+    }
+    unit.count++;
+    unit.allocations += count;
+    unit.bytes += bytes;
+    current_unit_ = -1;
+}
+
+void StageProfiler::print(std::ostream& out) const {
+    double total = 0.0;
+    for (const auto& stage : stages_) {
+        total += stage.seconds;
+    }
+    
+    out << "⏱️ Profile:" << std::setw(33) << "allocs" << std::setw(10) << "KiB" << std::setw(10) << "runtime" << std::endl;
+    for (const auto& stage : stages_) {
+        out << "   " << std::left << std::setw(14) << stage.name << std::right
+            << std::fixed << std::setprecision(3) << std::setw(9) << stage.seconds << "s "
+            << std::setprecision(1) << std::setw(5) << (total > 0.0 ? 100.0 * stage.seconds / total : 0.0) << "%"
+            << std::setw(10) << stage.allocations << std::setw(10) << stage.bytes / 1024 
+            << std::setw(10) << stage.runtime_allocations;
+        if (stage.count > 1) {
+            out << "  (" << stage.count << "x)";
+        }
+        out << std::endl;
+    }
+    out << "   " << std::left << std::setw(14) << "total" << std::right
+        << std::setprecision(3) << std::setw(9) << total << "s" << std::endl;
+    
+    if (!units_.empty()) {
+        out << "   " << std::left << std::setw(18) << "per call" << std::right << std::setw(9) << "calls"
+            << std::setw(10) << "mean" << std::setw(10) << "peak" << std::setw(12) << "peak bytes" << std::endl;
+        for (const auto& unit : units_) {
+            out << "   " << std::left << std::setw(18) << unit.name << std::right << std::setw(9) << unit.count
+                << std::setprecision(1) << std::setw(10) 
+                << (unit.count ? static_cast<double>(unit.allocations) / unit.count : 0.0)
+                << std::setw(10) << unit.peak_allocations << std::setw(12) << unit.peak_bytes << std::endl;
+        }
+    }
+    out << std::defaultfloat;
+}
+
+bool StageProfiler::parse_budgets(const std::string& list, std::vector<std::pair<std::string, uint64_t>>& budgets) {
+    budgets.clear();
+    std::stringstream entries(list);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        const size_t equals = entry.find('=');
+        if (equals == 0 || equals == std::string::npos || equals + 1 == entry.size() ||
+            entry.find_first_not_of("0123456789", equals + 1) != std::string::npos) {
+            return false;
+        }
+        budgets.emplace_back(entry.substr(0, equals), std::stoull(entry.substr(equals + 1)));
+    }
+    return !budgets.empty();
+}
+
+bool StageProfiler::check_budgets(const std::string& list, std::ostream& out) const {
+    std::vector<std::pair<std::string, uint64_t>> budgets;
+    if (!parse_budgets(list, budgets)) {
+        out << "❌ Invalid allocation budget list: " << list << std::endl;
+        return false;
+    }
+    
+    // A unit that never ran (e.g. no clustering in fast mode) has nothing to exceed
+    bool within = true;
+    for (const auto& budget : budgets) {
+        for (const auto& unit : units_) {
+            if (unit.name == budget.first && unit.peak_allocations > budget.second) {
+                out << "❌ Allocation budget exceeded: " << unit.name << " made " << unit.peak_allocations
+                    << " allocations in one call, budget " << budget.second << std::endl;
+                within = false;
+            }
+        }
+    }
+    return within;
+}
@@ -1,6 +1,13 @@
 // src/native/diarization/utils.cpp - FIXED: Namespace conflict resolved + Windows fallback
 #include "utils.h"
 #include "diarize-cli.h"
+#include "presets.h"
+#include "autotune.h"
+#include "cpu-affinity.h"
+#include "execution-provider.h"
+#include "simd-kernels.h"
+#include "signal-filters.h"
+#include "audio-buffer.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -21,7 +28,7 @@
             std::map<std::string, Value> obj_val;
             std::vector<Value> arr_val;
             int int_val = 0;
-            float float_val = 0.0f;
+            double float_val = 0.0;
             bool bool_val = false;
             enum Type { STRING, OBJECT, ARRAY, INT, FLOAT, BOOL } type = STRING;
             
@@ -30,6 +37,7 @@
             Value(const char* s) : str_val(s), type(STRING) {}
             Value(int i) : int_val(i), type(INT) {}
             Value(float f) : float_val(f), type(FLOAT) {}
+            Value(double d) : float_val(d), type(FLOAT) {}
             Value(bool b) : bool_val(b), type(BOOL) {}
             
             // Assignment operators
@@ -37,6 +45,7 @@
             Value& operator=(const char* s) { str_val = s; type = STRING; return *this; }
             Value& operator=(int i) { int_val = i; type = INT; return *this; }
             Value& operator=(float f) { float_val = f; type = FLOAT; return *this; }
+            Value& operator=(double d) { float_val = d; type = FLOAT; return *this; }
             Value& operator=(bool b) { bool_val = b; type = BOOL; return *this; }
             
             // Object access
@@ -166,6 +175,34 @@ std::vector<float> load_audio_file(const std::string& file_path, int target_samp
 #endif
 }
 
+AudioBuffer load_audio_buffer(const std::string& file_path, int target_sample_rate) {
+#ifdef USE_LIBSNDFILE
+    SF_INFO sf_info;
+    SNDFILE* sf_file = sf_open(file_path.c_str(), SFM_READ, &sf_info);
+    
+    if (!sf_file) {
+        throw std::runtime_error("Failed to open audio file: " + file_path);
+    }
+    
+    // Mono at the target rate needs no mixing or resampling: read 16-bit samples without a float copy
+    if (sf_info.channels == 1 && sf_info.samplerate == target_sample_rate) {
+        std::vector<int16_t> samples(static_cast<size_t>(sf_info.frames));
+        sf_count_t samples_read = sf_readf_short(sf_file, samples.data(), sf_info.frames);
+        sf_close(sf_file);
+        samples.resize(static_cast<size_t>(std::max<sf_count_t>(0, samples_read)));
+        return AudioBuffer::from_pcm16(std::move(samples));
+    }
+    sf_close(sf_file);
+    
+    const auto audio_data = load_audio_file(file_path, target_sample_rate);
+    return AudioBuffer::from_float(audio_data.data(), audio_data.size());
+#else
+    // Raw 16-bit PCM, as load_audio_simple reads it, but mapped instead of copied
+    (void)target_sample_rate;
+    return AudioBuffer::map_pcm16(file_path);
+#endif
+}
+
 std::vector<float> load_audio_simple(const std::string& file_path) {
     std::ifstream file(file_path, std::ios::binary);
     if (!file) {
@@ -192,17 +229,9 @@ std::vector<float> load_audio_simple(const std::string& file_path) {
 }
 
 void normalize_audio(std::vector<float>& audio) {
-    if (audio.empty()) return;
-    
-    float max_val = 0.0f;
-    for (float sample : audio) {
-        max_val = std::max(max_val, std::abs(sample));
-    }
-    
+    const float max_val = SimdKernels::max_abs(audio.data(), audio.size());
     if (max_val > 1e-6f) {
-        for (float& sample : audio) {
-            sample /= max_val;
-        }
+        SimdKernels::scale(audio.data(), 1.0f / max_val, audio.size());
     }
 }
 
@@ -230,20 +259,22 @@ std::vector<float> simple_resample(const std::vector<float>& audio, int source_r
 // JSON output formatting
 namespace Json {
 
-void output_results(const std::vector<AudioSegment>& segments, const DiarizeOptions& options) {
+void output_results(const std::vector<AudioSegment>& segments, const DiarizeOptions& options,
+                    const DiarizeStats& stats) {
     // FIXED: Use fully qualified names to avoid namespace conflict
     ::Json::Value root;
     ::Json::Value segments_json(::Json::arrayValue);
     
-    auto speaker_stats = generate_speaker_stats(segments);
+    auto speaker_stats = generate_speaker_stats(segments, options.sample_rate);
     
     for (const auto& segment : segments) {
+        // Segment boundaries are sample indices; seconds are derived only here
         ::Json::Value seg;
-        seg["start_time"] = segment.start_time;
-        seg["end_time"] = segment.end_time;
+        seg["start_time"] = Time::samples_to_seconds(segment.start_sample, options.sample_rate);
+        seg["end_time"] = Time::samples_to_seconds(segment.end_sample, options.sample_rate);
         seg["speaker_id"] = segment.speaker_id;
         seg["confidence"] = segment.confidence;
-        seg["duration"] = segment.end_time - segment.start_time;
+        seg["duration"] = Time::samples_to_seconds(segment.end_sample - segment.start_sample, options.sample_rate);
         
         if (!segment.text.empty()) {
             seg["text"] = segment.text;
@@ -254,7 +285,7 @@ void output_results(const std::vector<AudioSegment>& segments, const DiarizeOpti
     
     root["segments"] = segments_json;
     root["total_speakers"] = static_cast<int>(speaker_stats.size());
-    root["total_duration"] = segments.empty() ? 0.0f : segments.back().end_time;
+    root["total_duration"] = segments.empty() ? 0.0 : Time::samples_to_seconds(segments.back().end_sample, options.sample_rate);
     root["audio_path"] = options.audio_path;
     root["created_at"] = Time::get_current_timestamp();
     
@@ -264,8 +295,90 @@ void output_results(const std::vector<AudioSegment>& segments, const DiarizeOpti
     model_info["embedding_model"] = options.embedding_model_path;
     model_info["max_speakers"] = options.max_speakers;
     model_info["threshold"] = options.threshold;
+    model_info["mode"] = options.mode;
+    model_info["preset"] = options.preset;
+    model_info["intra_op_threads"] = options.intra_op_threads;
+    model_info["kernels"] = SimdKernels::isa();
+    model_info["segment_window"] = options.segment_window;
+    model_info["segment_hop"] = options.segment_hop;
+    model_info["embedding_duration"] = options.embedding_duration;
+    model_info["embedding_batch"] = options.embedding_batch_size;
+    model_info["segmentation_batch"] = options.segmentation_batch_size;
+    model_info["autotuned"] = options.autotuned;
+    if (options.cpu_limit > 0.0) {
+        model_info["cpu_limit"] = options.cpu_limit;
+    }
+    if (options.memory_limit > 0) {
+        model_info["memory_limit_mb"] = static_cast<double>(options.memory_limit) / (1 << 20);
+    }
+    ::Json::Value providers;
+    providers["segmentation"] = options.segmentation_provider;
+    providers["embedding"] = options.embedding_provider;
+    model_info["providers"] = providers;
+    if (!options.segmentation_cores.empty() || !options.embedding_cores.empty() || options.numa_node >= 0) {
+        model_info["segmentation_cores"] = CpuAffinity::format_cpu_list(
+            CpuAffinity::stage_cores(options.segmentation_cores, options.numa_node));
+        model_info["embedding_cores"] = CpuAffinity::format_cpu_list(
+            CpuAffinity::stage_cores(options.embedding_cores, options.numa_node));
+    }
+    if (!options.small_embedding_model_path.empty()) {
+        model_info["small_embedding_model"] = options.small_embedding_model_path;
+        model_info["cascade_margin"] = options.cascade_margin;
+    }
     root["model_info"] = model_info;
     
+    // Add processing counters
+    ::Json::Value processing;
+    processing["embedding_runs"] = static_cast<int>(stats.embedding_runs);
+    if (stats.cascade_items > 0) {
+        processing["cascade_items"] = static_cast<int>(stats.cascade_items);
+        processing["cascade_escalated"] = static_cast<int>(stats.cascade_escalated);
+        processing["cascade_escalated_fraction"] = 
+            static_cast<double>(stats.cascade_escalated) / static_cast<double>(stats.cascade_items);
+    }
+    if (stats.deadline_seconds > 0.0) {
+        ::Json::Value deadline;
+        deadline["seconds"] = stats.deadline_seconds;
+        deadline["elapsed_seconds"] = stats.elapsed_seconds;
+        deadline["met"] = stats.elapsed_seconds <= stats.deadline_seconds;
+        ::Json::Value degradations(::Json::arrayValue);
+        for (const auto& step : stats.degradations) {
+            degradations.append(step);
+        }
+        deadline["degradations"] = degradations;
+        processing["deadline"] = deadline;
+    }
+    if (!stats.profile.empty()) {
+        ::Json::Value profile;
+        ::Json::Value allocations;
+        for (const auto& stage : stats.profile) {
+            profile[stage.name] = stage.seconds;
+            allocations[stage.name]["pipeline"] = static_cast<double>(stage.allocations);
+            allocations[stage.name]["bytes"] = static_cast<double>(stage.bytes);
+            allocations[stage.name]["runtime"] = static_cast<double>(stage.runtime_allocations);
+        }
+        processing["profile_seconds"] = profile;
+        processing["profile_allocations"] = allocations;
+        
+        ::Json::Value units;
+        for (const auto& unit : stats.profile_units) {
+            units[unit.name]["calls"] = static_cast<int>(unit.count);
+            units[unit.name]["allocations"] = static_cast<double>(unit.allocations);
+            units[unit.name]["bytes"] = static_cast<double>(unit.bytes);
+            units[unit.name]["peak_allocations"] = static_cast<double>(unit.peak_allocations);
+            units[unit.name]["peak_bytes"] = static_cast<double>(unit.peak_bytes);
+        }
+        if (!stats.profile_units.empty()) {
+            processing["profile_units"] = units;
+        }
+        processing["allocation_tracking"] = AllocationCounter::tracking_build();
+    }
+    processing["cancelled"] = stats.cancelled;
+    if (stats.cancelled) {
+        processing["processed_until"] = Time::samples_to_seconds(stats.processed_samples, options.sample_rate);
+    }
+    root["processing"] = processing;
+    
     // Add speaker statistics
     ::Json::Value speakers_json(::Json::arrayValue);
     for (const auto& [speaker_id, stats] : speaker_stats) {
@@ -295,12 +408,13 @@ void output_results(const std::vector<AudioSegment>& segments, const DiarizeOpti
     }
 }
 
-std::map<int, std::map<std::string, float>> generate_speaker_stats(const std::vector<AudioSegment>& segments) {
+std::map<int, std::map<std::string, float>> generate_speaker_stats(const std::vector<AudioSegment>& segments,
+                                                                   int sample_rate) {
     std::map<int, std::map<std::string, float>> stats;
     
     for (const auto& segment : segments) {
         int speaker_id = segment.speaker_id;
-        float duration = segment.end_time - segment.start_time;
+        float duration = static_cast<float>(Time::samples_to_seconds(segment.end_sample - segment.start_sample, sample_rate));
         
         if (stats.find(speaker_id) == stats.end()) {
             stats[speaker_id] = {
@@ -338,6 +452,19 @@ DiarizeOptions parse_arguments(int argc, char* argv[]) {
     // FIXED: Set better default threshold for speaker diarization
     options.threshold = 0.01f;  // Much lower default threshold
     
+    // The preset goes first wherever it appears, so individual options override its knobs
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--preset" && !Presets::apply(argv[i + 1], options)) {
+            std::cerr << "❌ Unknown preset: " << argv[i + 1] << " (expected " << Presets::names() << ")" << std::endl;
+            exit(1);
+        }
+    }
+    
+    // Knobs given explicitly win over the per-host autotune cache
+    bool threads_set = false;
+    bool segmentation_batch_set = false;
+    bool embedding_batch_set = false;
+    
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
         
@@ -347,10 +474,100 @@ DiarizeOptions parse_arguments(int argc, char* argv[]) {
             options.segment_model_path = argv[++i];
         } else if (arg == "--embedding-model" && i + 1 < argc) {
             options.embedding_model_path = argv[++i];
+        } else if (arg == "--small-embedding-model" && i + 1 < argc) {
+            options.small_embedding_model_path = argv[++i];
+        } else if (arg == "--cascade-margin" && i + 1 < argc) {
+            options.cascade_margin = std::stof(argv[++i]);
+        } else if (arg == "--state" && i + 1 < argc) {
+            options.state_path = argv[++i];
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            options.checkpoint_path = argv[++i];
+        } else if (arg == "--checkpoint-interval" && i + 1 < argc) {
+            options.checkpoint_interval = std::stof(argv[++i]);
+        } else if (arg == "--resume") {
+            options.resume = true;
+        } else if (arg == "--shard" && i + 1 < argc) {
+            // I/N: this process handles shard I of N
+            std::string spec = argv[++i];
+            size_t slash = spec.find('/');
+            if (slash != std::string::npos) {
+                options.shard_index = std::stoi(spec.substr(0, slash));
+                options.shard_count = std::stoi(spec.substr(slash + 1));
+            }
+        } else if (arg == "--shard-overlap" && i + 1 < argc) {
+            options.shard_overlap = std::stof(argv[++i]);
+        } else if (arg == "--shard-dir" && i + 1 < argc) {
+            options.shard_dir = argv[++i];
+        } else if (arg == "--merge-shards") {
+            options.merge_shards = true;
+        } else if (arg == "--spool" && i + 1 < argc) {
+            options.spool_dir = argv[++i];
+        } else if (arg == "--worker-id" && i + 1 < argc) {
+            options.worker_id = argv[++i];
+        } else if (arg == "--spool-lease" && i + 1 < argc) {
+            options.spool_lease = std::stof(argv[++i]);
+        } else if (arg == "--deadline" && i + 1 < argc) {
+            options.deadline = std::max(0.0f, std::stof(argv[++i]));
+        } else if (arg == "--progress-fd" && i + 1 < argc) {
+            options.progress_fd = std::stoi(argv[++i]);
+        } else if (arg == "--control-fd" && i + 1 < argc) {
+            options.control_fd = std::stoi(argv[++i]);
         } else if (arg == "--max-speakers" && i + 1 < argc) {
             options.max_speakers = std::stoi(argv[++i]);
         } else if (arg == "--threshold" && i + 1 < argc) {
             options.threshold = std::stof(argv[++i]);
+        } else if (arg == "--mode" && i + 1 < argc) {
+            options.mode = argv[++i];
+        } else if (arg == "--embedding-batch" && i + 1 < argc) {
+            options.embedding_batch_size = std::max(1, std::stoi(argv[++i]));
+            embedding_batch_set = true;
+        } else if (arg == "--segmentation-batch" && i + 1 < argc) {
+            options.segmentation_batch_size = std::max(1, std::stoi(argv[++i]));
+            segmentation_batch_set = true;
+        } else if (arg == "--autotune") {
+            options.autotune = true;
+        } else if (arg == "--autotune-cache" && i + 1 < argc) {
+            options.autotune_cache = argv[++i];
+        } else if (arg == "--no-autotune-cache") {
+            options.use_autotune_cache = false;
+        } else if (arg == "--memory-fraction" && i + 1 < argc) {
+            options.memory_fraction = std::stof(argv[++i]);
+        } else if (arg == "--ignore-cgroup") {
+            options.use_cgroup = false;
+        } else if (arg == "--warmup") {
+            options.warmup = true;
+        } else if (arg == "--profile") {
+            options.profile = true;
+        } else if (arg == "--allocation-budget" && i + 1 < argc) {
+            options.allocation_budgets = argv[++i];
+            options.profile = true;
+        } else if (arg == "--provider" && i + 1 < argc) {
+            options.provider = argv[++i];
+        } else if (arg == "--segmentation-provider" && i + 1 < argc) {
+            options.segmentation_provider = argv[++i];
+        } else if (arg == "--embedding-provider" && i + 1 < argc) {
+            options.embedding_provider = argv[++i];
+        } else if (arg == "--segmentation-cores" && i + 1 < argc) {
+            options.segmentation_cores = argv[++i];
+        } else if (arg == "--embedding-cores" && i + 1 < argc) {
+            options.embedding_cores = argv[++i];
+        } else if (arg == "--numa-node" && i + 1 < argc) {
+            options.numa_node = std::stoi(argv[++i]);
+        } else if (arg == "--preset" && i + 1 < argc) {
+            ++i;  // Applied above
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.intra_op_threads = std::max(1, std::stoi(argv[++i]));
+            threads_set = true;
+        } else if (arg == "--segment-window" && i + 1 < argc) {
+            options.segment_window = std::stof(argv[++i]);
+        } else if (arg == "--segment-hop" && i + 1 < argc) {
+            options.segment_hop = std::stof(argv[++i]);
+        } else if (arg == "--embedding-duration" && i + 1 < argc) {
+            options.embedding_duration = std::stof(argv[++i]);
+        } else if (arg == "--min-segment" && i + 1 < argc) {
+            options.min_segment_duration = std::max(0.0f, std::stof(argv[++i]));
+        } else if (arg == "--fallback-segment" && i + 1 < argc) {
+            options.fallback_segment_duration = std::stof(argv[++i]);
         } else if (arg == "--output-format" && i + 1 < argc) {
             options.output_format = argv[++i];
         } else if (arg == "--output" && i + 1 < argc) {
@@ -369,6 +586,36 @@ DiarizeOptions parse_arguments(int argc, char* argv[]) {
         }
     }
     
+    std::vector<std::pair<std::string, uint64_t>> budgets;
+    if (!options.allocation_budgets.empty() && !StageProfiler::parse_budgets(options.allocation_budgets, budgets)) {
+        std::cerr << "❌ Invalid --allocation-budget: " << options.allocation_budgets 
+                 << " (expected unit=count,..., e.g. window_batch=8)" << std::endl;
+        exit(1);
+    }
+    
+    // Models without their own provider use --provider
+    for (std::string* provider : {&options.segmentation_provider, &options.embedding_provider}) {
+        if (provider->empty()) {
+            *provider = options.provider;
+        }
+        const auto& names = ExecutionProvider::names();
+        if (std::find(names.begin(), names.end(), *provider) == names.end()) {
+            std::cerr << "❌ Unknown provider: " << *provider << " (expected cpu, xnnpack or dnnl)" << std::endl;
+            exit(1);
+        }
+    }
+    
+    if (options.autotune_cache.empty()) {
+        options.autotune_cache = Autotuner::default_cache_path();
+    }
+    TuneResult tuned;
+    if (!options.autotune && options.use_autotune_cache && Autotuner::load(options.autotune_cache, options, tuned)) {
+        if (!threads_set) options.intra_op_threads = tuned.intra_op_threads;
+        if (!segmentation_batch_set) options.segmentation_batch_size = tuned.segmentation_batch_size;
+        if (!embedding_batch_set) options.embedding_batch_size = tuned.embedding_batch_size;
+        options.autotuned = true;
+    }
+    
     return options;
 }
 
@@ -385,6 +632,70 @@ void print_help() {
               << "    --threshold <FLOAT>         Speaker similarity threshold (default: 0.01)\n"
               << "                               Lower values = more speakers detected\n"
               << "                               Recommended range: 0.001 - 0.1\n"
+              << "    --mode <MODE>               Pipeline: standard (default), fast, uniform or changepoint\n"
+              << "                               standard: powerset speaker tracks, one embedding per track\n"
+              << "                               fast: segmentation model only, no embedding model needed\n"
+              << "                               uniform: fixed windows + batched embeddings, no segmentation\n"
+              << "                               model needed (used automatically if it is missing)\n"
+              << "                               changepoint: legacy change points, one embedding per segment\n"
+              << "    --embedding-batch <NUM>     Segments per embedding model run (default: 32)\n"
+              << "    --preset <NAME>             Speed/accuracy preset: fast, balanced (default) or accurate;\n"
+              << "                               the options below override single knobs of the preset\n"
+              << "    --threads <NUM>             ONNX Runtime intra-op threads per model (default: 4)\n"
+              << "    --segmentation-batch <NUM>  Windows per segmentation model run (default: 1)\n"
+              << "    --autotune                  Benchmark threads and batch sizes for the given models on\n"
+              << "                               this machine, cache the fastest and exit; later runs\n"
+              << "                               load the cache unless the knobs are given explicitly\n"
+              << "    --autotune-cache <PATH>     Tuned settings file (default: per-host file in the user\n"
+              << "                               cache directory)\n"
+              << "    --no-autotune-cache         Ignore tuned settings\n"
+              << "    --memory-fraction <F>       Share of the cgroup memory limit to use (default: 0.8)\n"
+              << "    --ignore-cgroup             Do not fit threads and batches to cgroup v2 limits\n"
+              << "    --warmup                    Run the models once at startup so the first window and\n"
+              << "                               embedding skip lazy initialization (always on with --spool)\n"
+              << "    --profile                   Print time per stage (model_load, warmup, audio_load,\n"
+              << "                               segmentation, embedding, clustering) to stderr and the JSON,\n"
+              << "                               with heap allocations of the pipeline and of ONNX Runtime\n"
+              << "    --allocation-budget <LIST>  Fail the run when a steady-state call allocates more than its\n"
+              << "                               budget, e.g. window_batch=8,embedding_batch=2,cluster_update=4\n"
+              << "                               (implies --profile)\n"
+              << "    --provider <NAME>           CPU execution provider: cpu (default), xnnpack or dnnl;\n"
+              << "                               unsupported nodes fall back to cpu\n"
+              << "    --segmentation-provider <NAME>  Provider of the segmentation model (default: --provider)\n"
+              << "    --embedding-provider <NAME> Provider of the embedding models (default: --provider)\n"
+              << "    --segmentation-cores <LIST> Pin the segmentation stage to these cores (e.g. 0-7)\n"
+              << "    --embedding-cores <LIST>    Pin the embedding stage to these cores (e.g. 8-15)\n"
+              << "    --numa-node <N>             Default core set of both stages: this NUMA node's cores\n"
+              << "    --segment-window <SEC>      Segmentation window (default: 3.2)\n"
+              << "    --segment-hop <SEC>         Segmentation hop (default: 1.6)\n"
+              << "    --embedding-duration <SEC>  Embedding model input length (default: 3.0)\n"
+              << "    --min-segment <SEC>         Shortest embedded change-point segment (default: 2.0)\n"
+              << "    --fallback-segment <SEC>    Segment length without change points (default: 25)\n"
+              << "    --small-embedding-model <PATH>\n"
+              << "                               Cheap embedding model run on every item first; only\n"
+              << "                               ambiguous assignments are re-embedded with the full model\n"
+              << "    --cascade-margin <FLOAT>    Similarity margin below which the small model escalates\n"
+              << "                               (default: 0.1)\n"
+              << "    --state <PATH>              Resumable state for a growing recording: reruns on the\n"
+              << "                               longer file only process the appended audio\n"
+              << "    --checkpoint <PATH>         Checkpoint a long job periodically (removed on completion)\n"
+              << "    --checkpoint-interval <SEC> Seconds between checkpoints (default: 60)\n"
+              << "    --resume                    Continue from --checkpoint if it matches the audio;\n"
+              << "                               results are identical to an uninterrupted run\n"
+              << "    --shard <I/N>               Diarize time shard I of N into --shard-dir\n"
+              << "    --shard-overlap <SEC>       Context shared with neighbouring shards (default: 10)\n"
+              << "    --shard-dir <DIR>           Shared directory for shard results\n"
+              << "    --merge-shards              Link the shards in --shard-dir into global speakers\n"
+              << "    --spool <DIR>               Worker mode: diarize recordings dropped into DIR/incoming\n"
+              << "                               with resident models; results go to DIR/done\n"
+              << "    --worker-id <ID>            Spool worker name (default: host-pid)\n"
+              << "    --spool-lease <SEC>         Heartbeat age after which a claimed job is recovered\n"
+              << "                               (default: 300)\n"
+              << "    --deadline <SEC>            Finish processing within SEC seconds, trading quality for\n"
+              << "                               speed as needed (standard and fast modes)\n"
+              << "    --progress-fd <FD>          Write JSON-lines progress events (stage, fraction, ETA) to FD\n"
+              << "    --control-fd <FD>           Read control messages from FD; \"cancel\" stops the job\n"
+              << "                               (SIGINT/SIGTERM also cancel; partial results are written)\n"
               << "    --output-format <FORMAT>    Output format: json (default: json)\n"
               << "    --output <PATH>             Output file (default: stdout)\n"
               << "    --verbose                   Verbose output with detailed progress\n"
@@ -402,6 +713,28 @@ void print_help() {
               << "                --segment-model segmentation-3.0.onnx \\\n"
               << "                --embedding-model embedding-1.0.onnx \\\n"
               << "                --threshold 0.05 --max-speakers 3\n\n"
+              << "    # Voice notes and short clips, segmentation model only:\n"
+              << "    diarize-cli --audio note.wav \\\n"
+              << "                --segment-model segmentation-3.0.onnx \\\n"
+              << "                --mode fast\n\n"
+              << "    # Small model first, full model only for ambiguous segments:\n"
+              << "    diarize-cli --audio meeting.wav \\\n"
+              << "                --segment-model segmentation-3.0.onnx \\\n"
+              << "                --embedding-model embedding-1.0.onnx \\\n"
+              << "                --small-embedding-model embedding-small.onnx\n\n"
+              << "    # Re-diarize a recording that is still growing:\n"
+              << "    diarize-cli --audio live.wav \\\n"
+              << "                --segment-model segmentation-3.0.onnx \\\n"
+              << "                --embedding-model embedding-1.0.onnx \\\n"
+              << "                --state live.wdstate\n\n"
+              << "    # Split a long recording across workers, then merge:\n"
+              << "    diarize-cli --audio day.wav --segment-model seg.onnx --embedding-model emb.onnx \\\n"
+              << "                --shard 0/4 --shard-dir /shared/day     # ... one per shard\n"
+              << "    diarize-cli --merge-shards --shard-dir /shared/day --output day.json\n\n"
+              << "    # Worker serving a shared spool directory (start one or more per host):\n"
+              << "    diarize-cli --spool /shared/spool \\\n"
+              << "                --segment-model segmentation-3.0.onnx \\\n"
+              << "                --embedding-model embedding-1.0.onnx\n\n"
               << "    # Output to file:\n"
               << "    diarize-cli --audio recording.wav \\\n"
               << "                --segment-model segmentation-3.0.onnx \\\n"
@@ -457,52 +790,16 @@ float cosine_similarity(const std::vector<float>& a, const std::vector<float>& b
         return 0.0f;
     }
     
-    float dot_product = 0.0f;
-    for (size_t i = 0; i < a.size(); i++) {
-        dot_product += a[i] * b[i];
-    }
-    
-    return std::max(-1.0f, std::min(1.0f, dot_product));
+    // Inputs are unit length, so the dot product is the cosine
+    return std::max(-1.0f, std::min(1.0f, SimdKernels::dot(a.data(), b.data(), a.size())));
 }
 
 void normalize_vector(std::vector<float>& vec) {
-    if (vec.empty()) return;
-    
-    float norm = 0.0f;
-    for (float val : vec) {
-        norm += val * val;
-    }
-    norm = std::sqrt(norm);
-    
-    if (norm > 1e-6f) {
-        for (float& val : vec) {
-            val /= norm;
-        }
-    }
+    SimdKernels::normalize(vec.data(), vec.size());
 }
 
 std::vector<size_t> find_peaks(const std::vector<float>& signal, float threshold, size_t min_distance) {
-    std::vector<size_t> peaks;
-    
-    for (size_t i = min_distance; i < signal.size() - min_distance; i++) {
-        if (signal[i] > threshold) {
-            bool is_peak = true;
-            
-            // Check if it's a local maximum
-            for (size_t j = i - min_distance; j <= i + min_distance; j++) {
-                if (j != i && signal[j] >= signal[i]) {
-                    is_peak = false;
-                    break;
-                }
-            }
-            
-            if (is_peak) {
-                peaks.push_back(i);
-            }
-        }
-    }
-    
-    return peaks;
+    return Signal::find_peaks(signal.data(), signal.size(), threshold, min_distance);
 }
 
 } // namespace Math
@@ -510,10 +807,17 @@ std::vector<size_t> find_peaks(const std::vector<float>& signal, float threshold
 // Time formatting utilities
 namespace Time {
 
-std::string format_time(float seconds) {
+double samples_to_seconds(int64_t sample, int sample_rate) {
+    if (sample_rate <= 0) {
+        return 0.0;
+    }
+    return static_cast<double>(sample) / sample_rate;
+}
+
+std::string format_time(double seconds) {
     int hours = static_cast<int>(seconds) / 3600;
     int minutes = (static_cast<int>(seconds) % 3600) / 60;
-    float secs = std::fmod(seconds, 60.0f);
+    double secs = std::fmod(seconds, 60.0);
     
     std::ostringstream oss;
     oss << std::setfill('0') << std::setw(2) << hours << ":"
@@ -0,0 +1,69 @@
+// src/native/diarization/tests/binary-io-test.cpp
+#include "binary-io.h"
+#include "test-support.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Round trip of the binary helpers, and length fields that claim more data than the file holds
+ */
+
+namespace {
+
+std::string temp_path() {
+    return "binary-io-test.tmp";
+}
+
+void check_round_trip() {
+    const std::vector<float> values = {1.0f, -2.5f, 3.25f};
+    {
+        std::ofstream out(temp_path(), std::ios::binary);
+        BinaryIO::write_string(out, "segmentation-3.0");
+        BinaryIO::write_floats(out, values);
+        BinaryIO::write_floats(out, {});
+    }
+    
+    std::ifstream in(temp_path(), std::ios::binary);
+    std::string text;
+    std::vector<float> read, empty = {7.0f};
+    CHECK(BinaryIO::read_string(in, text) && text == "segmentation-3.0");
+    CHECK(BinaryIO::read_floats(in, read) && read == values);
+    CHECK(BinaryIO::read_floats(in, empty) && empty.empty());
+}
+
+void check_bad_length(uint64_t size, size_t bytes_after) {
+    {
+        std::ofstream out(temp_path(), std::ios::binary);
+        BinaryIO::write_value(out, size);
+        const std::vector<char> payload(bytes_after, 0);
+        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    }
+    
+    std::ifstream in(temp_path(), std::ios::binary);
+    std::vector<float> values;
+    CHECK(!BinaryIO::read_floats(in, values));
+    CHECK(values.capacity() < 1024);
+    
+    if (size > bytes_after) {
+        std::ifstream text_in(temp_path(), std::ios::binary);
+        std::string text;
+        CHECK(!BinaryIO::read_string(text_in, text));
+        CHECK(text.capacity() < 1024);
+    }
+}
+
+} // namespace
+
+int main() {
+    check_round_trip();
+    
+    // Garbage lengths, lengths just past the data (truncated files) and within the hard caps
+    check_bad_length(~0ull, 64);
+    check_bad_length(1ull << 32, 64);
+    check_bad_length(1ull << 20, 1000);
+    check_bad_length(17, 4 * 17 - 1);
+    
+    std::remove(temp_path().c_str());
+    return TestSupport::finish("binary-io");
+}
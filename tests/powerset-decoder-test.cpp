@@ -0,0 +1,96 @@
+// src/native/diarization/tests/powerset-decoder-test.cpp
+#include "powerset-decoder.h"
+#include "test-support.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+/**
+ * Checks the powerset class layout and that the fixed-shape segmentation-3.0 kernel agrees
+ * with the generic loop. The generic loop is reached through a 3-speaker decoder that allows
+ * all three at once: its first seven classes are the segmentation-3.0 ones, and the eighth
+ * ({0,1,2}) is given a logit that makes its probability zero.
+ */
+
+namespace {
+
+constexpr size_t kClasses = 7;
+constexpr size_t kSpeakers = 3;
+
+// Speakers active in each segmentation-3.0 class: {}, {0}, {1}, {2}, {0,1}, {0,2}, {1,2}
+const bool kClassSpeakers[kClasses][kSpeakers] = {
+    {false, false, false},
+    {true, false, false},
+    {false, true, false},
+    {false, false, true},
+    {true, true, false},
+    {true, false, true},
+    {false, true, true},
+};
+
+void check_classes() {
+    const PowersetDecoder decoder(3, 2);
+    CHECK(decoder.num_classes() == kClasses);
+    CHECK(decoder.num_speakers() == kSpeakers);
+    CHECK(PowersetDecoder(3, 3).num_classes() == 8);
+    CHECK(PowersetDecoder(4, 2).num_classes() == 11);
+    
+    // One frame per class, each with that class far more likely than the others
+    std::vector<float> logits(kClasses * kClasses, 0.0f);
+    for (size_t c = 0; c < kClasses; c++) {
+        logits[c * kClasses + c] = 30.0f;
+    }
+    std::vector<float> activity(kClasses * kSpeakers, -1.0f);
+    decoder.decode(logits.data(), kClasses, activity.data());
+    
+    for (size_t c = 0; c < kClasses; c++) {
+        size_t active = 0;
+        for (size_t s = 0; s < kSpeakers; s++) {
+            const float value = activity[c * kSpeakers + s];
+            CHECK_NEAR(value, kClassSpeakers[c][s] ? 1.0f : 0.0f, 1e-6);
+            active += value > 0.5f;
+        }
+        // The overlap classes switch on two speakers at once
+        CHECK(active == (c == 0 ? 0 : c <= 3 ? 1 : 2));
+    }
+}
+
+void check_against_generic(size_t num_frames, std::mt19937& rng) {
+    std::normal_distribution<float> dist(0.0f, 4.0f);
+    std::vector<float> logits(num_frames * kClasses);
+    std::vector<float> padded(num_frames * (kClasses + 1));
+    for (size_t t = 0; t < num_frames; t++) {
+        for (size_t c = 0; c < kClasses; c++) {
+            logits[t * kClasses + c] = dist(rng);
+            padded[t * (kClasses + 1) + c] = logits[t * kClasses + c];
+        }
+        padded[t * (kClasses + 1) + kClasses] = -1e30f;
+    }
+    
+    std::vector<float> fast(num_frames * kSpeakers + 1, 42.0f);
+    std::vector<float> generic(num_frames * kSpeakers, 0.0f);
+    PowersetDecoder(3, 2).decode(logits.data(), num_frames, fast.data());
+    PowersetDecoder(3, 3).decode(padded.data(), num_frames, generic.data());
+    
+    for (size_t i = 0; i < generic.size(); i++) {
+        CHECK_NEAR(fast[i], generic[i], 1e-5);
+        CHECK(fast[i] >= 0.0f && fast[i] <= 1.0f);
+    }
+    CHECK(fast.back() == 42.0f);
+}
+
+} // namespace
+
+int main() {
+    check_classes();
+    
+    // 186 frames take decode_segmentation3<186>, every other count the run-time length version
+    std::mt19937 rng(20261017);
+    for (size_t num_frames : {0, 1, 7, 185, 186, 187, 293}) {
+        for (int trial = 0; trial < 5; trial++) {
+            check_against_generic(num_frames, rng);
+        }
+    }
+    
+    return TestSupport::finish("powerset-decoder");
+}
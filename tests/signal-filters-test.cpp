@@ -0,0 +1,184 @@
+// src/native/diarization/tests/signal-filters-test.cpp
+#include "signal-filters.h"
+#include "test-support.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+/**
+ * Checks the streaming filters against the quadratic loops they replaced, on random input with
+ * many ties (values are quantized to tenths), and that feeding a sequence in random pieces gives
+ * exactly the result of one push
+ */
+
+namespace {
+
+std::mt19937 rng(20261017);
+
+std::vector<float> random_sequence(size_t n) {
+    std::uniform_int_distribution<int> dist(0, 10);
+    std::vector<float> values(n);
+    for (float& value : values) {
+        value = dist(rng) / 10.0f;
+    }
+    return values;
+}
+
+/**
+ * Split [0, n) into random pieces, empty ones included
+ */
+std::vector<size_t> random_pieces(size_t n) {
+    std::uniform_int_distribution<size_t> dist(0, 9);
+    std::vector<size_t> pieces;
+    size_t total = 0;
+    while (total < n) {
+        const size_t piece = std::min(dist(rng), n - total);
+        pieces.push_back(piece);
+        total += piece;
+    }
+    return pieces;
+}
+
+// The Utils::Math::find_peaks loop before PeakPicker, with the short-input underflow guarded
+std::vector<size_t> reference_peaks(const std::vector<float>& signal, float threshold, size_t min_distance) {
+    std::vector<size_t> peaks;
+    if (signal.size() < 2 * min_distance) {
+        return peaks;
+    }
+    for (size_t i = min_distance; i < signal.size() - min_distance; i++) {
+        if (signal[i] > threshold) {
+            bool is_peak = true;
+            for (size_t j = i - min_distance; j <= i + min_distance; j++) {
+                if (j != i && signal[j] >= signal[i]) {
+                    is_peak = false;
+                    break;
+                }
+            }
+            if (is_peak) {
+                peaks.push_back(i);
+            }
+        }
+    }
+    return peaks;
+}
+
+// Median of the window cut to the sequence, mean of the middle two for an even count
+std::vector<float> reference_median(const std::vector<float>& values, size_t width) {
+    const size_t half = width / 2;
+    std::vector<float> out;
+    for (size_t i = 0; i < values.size(); i++) {
+        const size_t begin = i >= half ? i - half : 0;
+        const size_t end = std::min(values.size(), i + half + 1);
+        std::vector<float> window(values.begin() + begin, values.begin() + end);
+        std::sort(window.begin(), window.end());
+        const size_t mid = window.size() / 2;
+        out.push_back(window.size() % 2 ? window[mid] : 0.5f * (window[mid - 1] + window[mid]));
+    }
+    return out;
+}
+
+std::vector<Signal::Region> reference_regions(const std::vector<float>& values, float onset, float offset) {
+    std::vector<Signal::Region> regions;
+    bool active = false;
+    size_t start = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (!active && values[i] >= onset) {
+            active = true;
+            start = i;
+        } else if (active && values[i] < offset) {
+            regions.push_back({start, i});
+            active = false;
+        }
+    }
+    if (active) {
+        regions.push_back({start, values.size()});
+    }
+    return regions;
+}
+
+bool same_regions(const std::vector<Signal::Region>& a, const std::vector<Signal::Region>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Signal::Region& x, const Signal::Region& y) {
+        return x.start == y.start && x.end == y.end;
+    });
+}
+
+void check_peaks(const std::vector<float>& values, float threshold, size_t min_distance) {
+    const std::vector<size_t> expected = reference_peaks(values, threshold, min_distance);
+    CHECK(Signal::find_peaks(values.data(), values.size(), threshold, min_distance) == expected);
+    
+    // Piecewise, twice over: reset() must leave no state behind
+    Signal::PeakPicker picker(threshold, min_distance);
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<size_t> peaks;
+        size_t offset = 0;
+        for (size_t piece : random_pieces(values.size())) {
+            picker.push(values.data() + offset, piece, peaks);
+            offset += piece;
+        }
+        CHECK(peaks == expected);
+        picker.reset();
+    }
+}
+
+void check_median(const std::vector<float>& values, size_t width) {
+    const std::vector<float> expected = reference_median(values, width);
+    CHECK(Signal::median_filter(values.data(), values.size(), width) == expected);
+    
+    Signal::RunningMedian filter(width);
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<float> out;
+        size_t offset = 0;
+        for (size_t piece : random_pieces(values.size())) {
+            filter.push(values.data() + offset, piece, out);
+            offset += piece;
+        }
+        filter.finish(out);
+        CHECK(out == expected);
+    }
+}
+
+void check_hysteresis(const std::vector<float>& values, float onset, float offset_threshold) {
+    const std::vector<Signal::Region> expected = reference_regions(values, onset, offset_threshold);
+    CHECK(same_regions(Signal::binarize(values.data(), values.size(), onset, offset_threshold), expected));
+    
+    Signal::Hysteresis hysteresis(onset, offset_threshold);
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<Signal::Region> regions;
+        size_t offset = 0;
+        for (size_t piece : random_pieces(values.size())) {
+            hysteresis.push(values.data() + offset, piece, regions);
+            offset += piece;
+        }
+        hysteresis.finish(regions);
+        CHECK(same_regions(regions, expected));
+        CHECK(!hysteresis.active());
+    }
+}
+
+} // namespace
+
+int main() {
+    // Lengths from empty through shorter than 2d (no peaks, no underflow) to long sequences
+    for (size_t n : {0, 1, 2, 3, 5, 8, 13, 40, 257, 1000}) {
+        for (int trial = 0; trial < 20; trial++) {
+            const std::vector<float> values = random_sequence(n);
+            for (size_t min_distance : {0, 1, 2, 3, 7, 20}) {
+                check_peaks(values, 0.3f, min_distance);
+            }
+            for (size_t width : {1, 3, 5, 11, 51}) {
+                check_median(values, width);
+            }
+            check_hysteresis(values, 0.5f, 0.5f);
+            check_hysteresis(values, 0.6f, 0.3f);
+        }
+    }
+    
+    // A plateau has no strict maximum; a lone spike shorter than 2d from an end is never a peak
+    const std::vector<float> plateau = {0.0f, 0.9f, 0.9f, 0.0f, 0.0f};
+    CHECK(Signal::find_peaks(plateau.data(), plateau.size(), 0.1f, 1).empty());
+    const std::vector<float> spike = {0.0f, 1.0f, 0.0f};
+    CHECK(Signal::find_peaks(spike.data(), spike.size(), 0.1f, 2).empty());
+    CHECK(Signal::find_peaks(spike.data(), spike.size(), 0.1f, 1) == std::vector<size_t>{1});
+    
+    return TestSupport::finish("signal-filters");
+}
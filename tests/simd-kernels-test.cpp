@@ -0,0 +1,235 @@
+// src/native/diarization/tests/simd-kernels-test.cpp
+#include "simd-kernels.h"
+#include "test-support.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/**
+ * Checks the dispatched kernels against plain loops. ctest runs this once per kernel set
+ * (DIARIZATION_KERNELS=scalar|avx2|avx512, plus the detected one); a set the CPU lacks is
+ * skipped. Every length from 0 to 67 covers empty input, partial vectors and tails for
+ * 4, 8 and 16 lanes; 192, 256 and 512 cover the fixed-length kernels, and every kernel also
+ * runs at 1-3 floats past a 64-byte boundary.
+ */
+
+namespace {
+
+constexpr size_t kMaxOffset = 3;
+constexpr size_t kFixedLengths[] = {192, 256, 512};
+constexpr float kTolerance = 2e-5f;
+
+std::vector<size_t> test_lengths() {
+    std::vector<size_t> lengths;
+    for (size_t n = 0; n <= 67; n++) {
+        lengths.push_back(n);
+    }
+    for (size_t n : kFixedLengths) {
+        lengths.push_back(n);
+    }
+    return lengths;
+}
+
+/**
+ * 64-byte aligned storage handing out views that start offset elements in
+ */
+template <typename T>
+class OffsetBuffer {
+public:
+    explicit OffsetBuffer(size_t size) : storage_(size + kMaxOffset + 64 / sizeof(T)) {}
+    
+    T* at(size_t offset) {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(storage_.data());
+        const uintptr_t aligned = (base + 63) & ~static_cast<uintptr_t>(63);
+        return reinterpret_cast<T*>(aligned) + offset;
+    }
+    
+private:
+    std::vector<T> storage_;
+};
+
+std::mt19937 rng(20261017);
+
+void fill(float* values, size_t n) {
+    std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+    for (size_t i = 0; i < n; i++) {
+        values[i] = dist(rng);
+    }
+}
+
+void fill(int16_t* values, size_t n) {
+    std::uniform_int_distribution<int> dist(-32768, 32767);
+    for (size_t i = 0; i < n; i++) {
+        values[i] = static_cast<int16_t>(dist(rng));
+    }
+}
+
+// Reference loops, in double so reassociation in the vector kernels stays within tolerance
+double reference_dot(const float* a, const float* b, size_t n, double* magnitude) {
+    double sum = 0.0;
+    *magnitude = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        sum += static_cast<double>(a[i]) * b[i];
+        *magnitude += std::fabs(static_cast<double>(a[i]) * b[i]);
+    }
+    return sum;
+}
+
+template <typename T>
+void reference_emphasis(float* y, const T* x, float gain, float coeff, size_t n) {
+    double previous = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double current = static_cast<double>(x[i]) * gain;
+        y[i] = static_cast<float>(current - coeff * previous);
+        previous = current;
+    }
+}
+
+void check_dot(size_t n, size_t offset) {
+    OffsetBuffer<float> a(n), b(n);
+    fill(a.at(offset), n);
+    fill(b.at(offset), n);
+    double magnitude = 0.0;
+    const double expected = reference_dot(a.at(offset), b.at(offset), n, &magnitude);
+    const float actual = SimdKernels::dot(a.at(offset), b.at(offset), n);
+    if (std::fabs(actual - expected) > kTolerance * (1.0 + magnitude)) {
+        std::fprintf(stderr, "   dot n=%zu offset=%zu: %f vs %f\n", n, offset, actual, expected);
+        CHECK(!"dot matches the reference");
+    }
+}
+
+void check_max_abs(size_t n, size_t offset) {
+    OffsetBuffer<float> a(n);
+    fill(a.at(offset), n);
+    float expected = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        expected = std::fmax(expected, std::fabs(a.at(offset)[i]));
+    }
+    // Put the peak at the very end as well, so a tail that is skipped shows up
+    if (n > 0) {
+        a.at(offset)[n - 1] = -3.0f;
+        expected = 3.0f;
+    }
+    CHECK(SimdKernels::max_abs(a.at(offset), n) == expected);
+}
+
+void check_scale(size_t n, size_t offset) {
+    OffsetBuffer<float> a(n + 1);
+    fill(a.at(offset), n + 1);
+    std::vector<float> expected(a.at(offset), a.at(offset) + n + 1);
+    for (size_t i = 0; i < n; i++) {
+        expected[i] *= 0.37f;
+    }
+    SimdKernels::scale(a.at(offset), 0.37f, n);
+    // One multiply per element: exact, and the element past the end is untouched
+    CHECK(std::memcmp(a.at(offset), expected.data(), (n + 1) * sizeof(float)) == 0);
+}
+
+void check_normalize(size_t n, size_t offset) {
+    OffsetBuffer<float> a(n);
+    fill(a.at(offset), n);
+    std::vector<float> original(a.at(offset), a.at(offset) + n);
+    double magnitude = 0.0;
+    const double length = std::sqrt(reference_dot(original.data(), original.data(), n, &magnitude));
+    SimdKernels::normalize(a.at(offset), n);
+    for (size_t i = 0; i < n; i++) {
+        const double expected = length > 1e-6 ? original[i] / length : original[i];
+        CHECK_NEAR(a.at(offset)[i], expected, kTolerance);
+    }
+}
+
+void check_gemv(size_t cols, size_t offset) {
+    for (size_t rows : {0, 1, 3, 5}) {
+        OffsetBuffer<float> matrix(rows * cols), x(cols);
+        fill(matrix.at(offset), rows * cols);
+        fill(x.at(offset), cols);
+        std::vector<float> y(rows + 1, 42.0f);
+        SimdKernels::gemv(matrix.at(offset), rows, cols, x.at(offset), y.data());
+        for (size_t r = 0; r < rows; r++) {
+            double magnitude = 0.0;
+            const double expected = reference_dot(matrix.at(offset) + r * cols, x.at(offset), cols, &magnitude);
+            CHECK(std::fabs(y[r] - expected) <= kTolerance * (1.0 + magnitude));
+        }
+        CHECK(y[rows] == 42.0f);
+    }
+}
+
+void check_gain_emphasis(size_t n, size_t offset) {
+    for (float coeff : {0.0f, 0.97f}) {
+        OffsetBuffer<float> x(n), y(n + 1);
+        fill(x.at(offset), n);
+        std::vector<float> expected(n);
+        reference_emphasis(expected.data(), x.at(offset), 1.5f, coeff, n);
+        y.at(offset)[n] = 42.0f;
+        SimdKernels::gain_emphasis(y.at(offset), x.at(offset), 1.5f, coeff, n);
+        for (size_t i = 0; i < n; i++) {
+            CHECK_NEAR(y.at(offset)[i], expected[i], kTolerance);
+        }
+        CHECK(y.at(offset)[n] == 42.0f);
+    }
+}
+
+void check_max_abs_pcm16(size_t n, size_t offset) {
+    OffsetBuffer<int16_t> a(n);
+    fill(a.at(offset), n);
+    int32_t expected = 0;
+    for (size_t i = 0; i < n; i++) {
+        expected = std::max(expected, std::abs(static_cast<int32_t>(a.at(offset)[i])));
+    }
+    CHECK(SimdKernels::max_abs_pcm16(a.at(offset), n) == expected);
+    
+    // -32768 has no positive int16 counterpart: it must come back as 32768, also in the tail
+    if (n > 0) {
+        a.at(offset)[n - 1] = -32768;
+        CHECK(SimdKernels::max_abs_pcm16(a.at(offset), n) == 32768);
+    }
+}
+
+void check_pcm16_emphasis(size_t n, size_t offset) {
+    const float gain = 1.0f / 32768.0f;
+    for (float coeff : {0.0f, 0.97f}) {
+        OffsetBuffer<int16_t> x(n);
+        OffsetBuffer<float> y(n + 1);
+        fill(x.at(offset), n);
+        std::vector<float> expected(n);
+        reference_emphasis(expected.data(), x.at(offset), gain, coeff, n);
+        y.at(offset)[n] = 42.0f;
+        SimdKernels::pcm16_emphasis(y.at(offset), x.at(offset), gain, coeff, n);
+        for (size_t i = 0; i < n; i++) {
+            CHECK_NEAR(y.at(offset)[i], expected[i], kTolerance);
+        }
+        CHECK(y.at(offset)[n] == 42.0f);
+    }
+}
+
+} // namespace
+
+int main() {
+    // An unsupported DIARIZATION_KERNELS falls back to the detected set; that run adds nothing
+    const char* forced = std::getenv("DIARIZATION_KERNELS");
+    if (forced && *forced && std::strcmp(forced, SimdKernels::isa()) != 0) {
+        std::printf("⏭️  %s kernels not supported on this CPU (using %s)\n", forced, SimdKernels::isa());
+        return TestSupport::kSkipped;
+    }
+    std::printf("🧪 Testing %s kernels\n", SimdKernels::isa());
+    
+    for (size_t n : test_lengths()) {
+        for (size_t offset = 0; offset <= kMaxOffset; offset++) {
+            check_dot(n, offset);
+            check_max_abs(n, offset);
+            check_scale(n, offset);
+            check_normalize(n, offset);
+            check_gemv(n, offset);
+            check_gain_emphasis(n, offset);
+            check_max_abs_pcm16(n, offset);
+            check_pcm16_emphasis(n, offset);
+        }
+    }
+    
+    return TestSupport::finish("simd-kernels");
+}
@@ -0,0 +1,113 @@
+// src/native/diarization/tests/speaker-tracker-test.cpp
+#include "speaker-tracker.h"
+#include "test-support.h"
+#include <algorithm>
+#include <vector>
+
+/**
+ * Checks that local speakers are linked across overlapping windows when every window lists
+ * the same three people in a different column order
+ */
+
+namespace {
+
+constexpr int64_t kWindowSamples = 1000;
+constexpr size_t kFrames = 100;       // 10 samples per frame
+constexpr int64_t kStepSamples = 500; // Consecutive windows overlap by half
+constexpr size_t kSpeakers = 3;
+constexpr size_t kWindows = 5;
+
+// Speaker g talks in every third block of 10 frames; speaker 0 also overlaps the others briefly
+float truth(size_t speaker, int64_t frame) {
+    const bool talking = (frame / 10) % 3 == static_cast<int64_t>(speaker) || (speaker == 0 && frame % 25 < 4);
+    return talking ? 0.9f : 0.05f;
+}
+
+// Global speaker shown in each local column, per window
+const size_t kColumns[kWindows][kSpeakers] = {
+    {0, 1, 2},
+    {2, 0, 1},
+    {1, 2, 0},
+    {1, 0, 2},
+    {2, 1, 0},
+};
+
+WindowActivity make_window(size_t index) {
+    WindowActivity window;
+    window.start_sample = static_cast<int64_t>(index) * kStepSamples;
+    window.num_frames = kFrames;
+    window.num_speakers = kSpeakers;
+    window.activity.resize(kFrames * kSpeakers);
+    const int64_t first_frame = window.start_sample * static_cast<int64_t>(kFrames) / kWindowSamples;
+    for (size_t t = 0; t < kFrames; t++) {
+        for (size_t s = 0; s < kSpeakers; s++) {
+            window.activity[t * kSpeakers + s] = truth(kColumns[index][s], first_frame + static_cast<int64_t>(t));
+        }
+    }
+    return window;
+}
+
+void check_permuted_linking() {
+    SpeakerTracker tracker(kWindowSamples);
+    for (size_t w = 0; w < kWindows; w++) {
+        tracker.add_window(make_window(w));
+    }
+    
+    CHECK(tracker.frames_per_window() == kFrames);
+    CHECK(tracker.sample_to_frame(kStepSamples) == 50);
+    CHECK(tracker.frame_to_sample(50) == kStepSamples);
+    
+    // One track per person, every local speaker after the first window linked into it
+    const auto& tracks = tracker.tracks();
+    CHECK(tracks.size() == kSpeakers);
+    CHECK(tracker.link_count() == (kWindows - 1) * kSpeakers);
+    if (tracks.size() != kSpeakers) {
+        return;
+    }
+    
+    // Track ids follow the columns of the first window
+    const int64_t last_frame = static_cast<int64_t>((kWindows - 1) * 50 + kFrames);
+    for (size_t id = 0; id < kSpeakers; id++) {
+        const SpeakerTrack& track = tracks[id];
+        CHECK(track.id == static_cast<int>(id));
+        CHECK(track.window_count == kWindows);
+        CHECK(track.first_frame == 0);
+        CHECK(track.end_frame() == last_frame);
+        for (int64_t frame = 0; frame < last_frame; frame++) {
+            CHECK_NEAR(track.activity(frame), truth(kColumns[0][id], frame), 1e-6);
+        }
+        
+        // The three people share every window, so each conflicts with the other two
+        std::vector<int> conflicts = track.conflicts;
+        std::sort(conflicts.begin(), conflicts.end());
+        std::vector<int> expected;
+        for (size_t other = 0; other < kSpeakers; other++) {
+            if (other != id) expected.push_back(static_cast<int>(other));
+        }
+        CHECK(conflicts == expected);
+    }
+}
+
+void check_no_overlap() {
+    // Windows that do not overlap cannot be linked: every local speaker starts a track
+    SpeakerTracker tracker(kWindowSamples);
+    WindowActivity first = make_window(0);
+    WindowActivity second = make_window(0);
+    second.start_sample = 2 * kWindowSamples;
+    tracker.add_window(first);
+    tracker.add_window(second);
+    CHECK(tracker.tracks().size() == 2 * kSpeakers);
+    CHECK(tracker.link_count() == 0);
+    
+    tracker.reset();
+    CHECK(tracker.tracks().empty());
+    CHECK(tracker.frames_per_window() == 0);
+}
+
+} // namespace
+
+int main() {
+    check_permuted_linking();
+    check_no_overlap();
+    return TestSupport::finish("speaker-tracker");
+}
@@ -0,0 +1,55 @@
+// src/native/diarization/tests/test-support.h
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+/**
+ * Minimal checks for the unit tests: a failed CHECK prints the expression and its location and
+ * marks the run as failed, but the test keeps going so one run reports every mismatch
+ */
+namespace TestSupport {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+    
+    inline void fail(const char* file, int line, const char* expression) {
+        std::fprintf(stderr, "❌ %s:%d: %s\n", file, line, expression);
+        failures()++;
+    }
+    
+    /**
+     * |actual - expected| within tolerance, relative to the larger magnitude above 1
+     */
+    inline bool near(double actual, double expected, double tolerance) {
+        const double scale = std::fmax(1.0, std::fmax(std::fabs(actual), std::fabs(expected)));
+        return std::fabs(actual - expected) <= tolerance * scale;
+    }
+    
+    /**
+     * Exit code for main(): 0 when every check passed
+     */
+    inline int finish(const char* name) {
+        if (failures() > 0) {
+            std::fprintf(stderr, "❌ %s: %d failed checks\n", name, failures());
+            return 1;
+        }
+        std::printf("✅ %s passed\n", name);
+        return 0;
+    }
+    
+    // ctest reports a test that exits with this code as skipped (SKIP_RETURN_CODE)
+    constexpr int kSkipped = 77;
+}
+
+#define CHECK(expression) \
+    do { \
+        if (!(expression)) TestSupport::fail(__FILE__, __LINE__, #expression); \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        if (!TestSupport::near((actual), (expected), (tolerance))) \
+            TestSupport::fail(__FILE__, __LINE__, #actual " ~= " #expected); \
+    } while (0)